@@ -3,6 +3,8 @@
 
 #include <glm/glm.hpp>
 
+#include "framePacer.h"
+
 #include <sstream>
 #include <vector>
 
@@ -30,16 +32,20 @@ public:
 
 	bool getWindowInfo(std::string & windowName, glm::uvec2 & size);
 
+	bool getPacingInfo(PacingMode & mode, float & frameCap);
+
 	bool getCameraInfo(glm::vec3 & eyePos, glm::vec3 & eyeLoc);
 
 	bool getShaderSet(std::string & shaderSetName, std::string & vertexShaderFile, std::string & fragmentShaderFile);
 
 	bool getShaderSetActive(std::string & set);
 
-	bool getMenuState(bool & menu, glm::uvec2 & size);
+	bool getMenuState(bool & menu, glm::uvec2 & size, bool & ownWindow);
 
 	bool getWorldGravity(glm::vec3 & gravity);
 
+	bool getPhysicsRate(float & rate, unsigned int & maxSteps);
+
 	bool getLightingInfo(glm::vec3 & ambientLevel, float & shininess, std::vector<glm::vec3> & spotlightLocs);
 
 	bool getObjects(std::vector<objectModel> & objects);
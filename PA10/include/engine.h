@@ -5,9 +5,14 @@
 #include "window.h"
 #include "graphics.h"
 #include "scoreboard.h"
+#include "frameProfiler.h"
+#include "framePacer.h"
 
 #include "configLoader.hpp"
 
+//Chrome trace written on F12 & on exit - relative to the working directory. Only with USE_TRACING
+#define TRACE_FILE "trace.json"
+
 class Engine {
 public:
 	Engine(const std::string & launchFile);
@@ -15,27 +20,31 @@ public:
 	bool Initialize(void);
 	void Run(void);
 
-	unsigned int getDT(void);
-
 	static long long GetCurrentTimeMillis(void);
 
 private:
 	Window * m_window;
 	Graphics * m_graphics;
+	FramePacer * m_pacer;
 	Scoreboard m_scoreboard;
+	FrameProfiler m_profiler; //times parts of every frame - shown in menu
 
 	SDL_Event m_event;
 
 	Menu * m_menu;
 	glm::uvec2 m_menuSize;
+	bool m_menuWindow; //menu gets a window of its own instead of being drawn over the game
 	long long m_menuLastTime; // last time when menu was created or destoryed
 
 	ConfigFileParser m_configFile; //used to get parameters from
 
-	unsigned int m_DT;
-	long long m_currentTimeMillis;
+	float m_DT; //length of last frame in milliseconds
 	bool m_running;
 
+	//physics & game logic run in fixed steps - rendering interpolates between the last two
+	double m_physicsStep; //seconds
+	unsigned int m_maxPhysicsSteps; //per frame
+
 	bool m_shift; //keeps track of shift being pressed
 	void EventChecker(void);
 	void HandleEvent(const SDL_Event & event);
@@ -43,6 +52,8 @@ private:
 	bool StartMenu(const glm::vec3 & eyePos, const glm::vec3 & eyeLoc);
 	bool CloseMenu(void);
 
+	void WriteTrace(void);
+
 };
 
 #endif // ENGINE_H
@@ -0,0 +1,71 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <vector>
+
+//number of frames kept for jitter statistics
+#define PACER_HISTORY 240
+
+//capped mode sleeps until this long before the frame is due & spins for the rest - OS sleeps can overshoot by about this much
+#define PACER_SPIN_MARGIN_US 1000
+
+//how the end of a frame is paced
+enum PacingMode {
+	PACING_UNCAPPED = 0, //present right away - lowest latency, keeps CPU & GPU busy
+	PACING_VSYNC = 1, //swap waits for vertical blank
+	PACING_ADAPTIVE = 2, //waits for vertical blank, but frames that miss it are presented right away instead of waiting for the next one
+	PACING_CAPPED = 3, //no vsync - CPU waits out the rest of each frame (sleep, then spin for precision)
+	NUM_PACING_MODES
+};
+
+//frame time statistics of the kept frames, in milliseconds
+typedef struct FramePacing {
+	float m_mean;
+	float m_jitter; //standard deviation of frame times
+	float m_max;
+} FramePacing;
+
+//paces frames & measures the time from one presented frame to the next
+class FramePacer {
+
+public:
+	FramePacer(PacingMode mode, float frameCap); //frame cap (frames per second) is only used in capped mode
+
+	//FramePacer is not meant to be copied or moved
+	FramePacer(const FramePacer &) = delete;
+	FramePacer(FramePacer &&) = delete;
+	FramePacer& operator=(const FramePacer &) = delete;
+	FramePacer& operator=(FramePacer&&) = delete;
+
+	//sets swap interval of current OpenGL context. A mode the driver does not support falls back to the next simpler one (adaptive ->
+	//vsync -> uncapped) - returns the mode used
+	PacingMode Initialize(void);
+
+	void EndFrame(void); //call once per frame right after the swap - waits out the frame in capped mode
+
+	PacingMode GetMode(void) const;
+	float GetFrameCap(void) const;
+	FramePacing GetPacing(void) const;
+
+	static const char * GetModeName(PacingMode mode);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	void WaitUntil(Clock::time_point deadline) const;
+
+	PacingMode m_mode;
+	const float m_frameCap;
+	const Clock::duration m_framePeriod;
+
+	Clock::time_point m_deadline; //when current frame is due in capped mode
+	Clock::time_point m_lastFrame;
+	bool m_started;
+
+	std::vector<float> m_frameTimes; //ring buffer
+	unsigned int m_current;
+	unsigned int m_numFrames;
+};
+
+#endif /* FRAMEPACER_H */
@@ -0,0 +1,135 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include "graphics_headers.h"
+
+#include <chrono>
+#include <vector>
+
+//number of frames kept for graphs & percentiles
+#define PROFILER_HISTORY 240
+
+//parts of a frame timed on the CPU. Stages can be nested - a stage only counts the time not spent in stages inside it
+enum ProfileStage {
+	STAGE_EVENTS = 0,
+	STAGE_UPDATE = 1,
+	STAGE_PHYSICS = 2,
+	STAGE_RENDER = 3,
+	STAGE_SWAP = 4,
+	STAGE_MENU = 5,
+	NUM_STAGES
+};
+
+//render passes timed on the GPU
+enum ProfilePass {
+	PASS_SCENE = 0,
+	PASS_MENU = 1,
+	NUM_PASSES
+};
+
+//times of one frame in milliseconds
+typedef struct FrameTimes {
+	float m_stages[NUM_STAGES];
+	float m_passes[NUM_PASSES]; //negative until the GPU has finished the pass
+	float m_frame; //whole frame, including time spent outside of stages (e.g. frame rate cap)
+} FrameTimes;
+
+//times stages of every frame on the CPU & render passes on the GPU, keeping the last PROFILER_HISTORY frames
+//GPU queries are double buffered: results are read when their set comes around again 2 frames later, and only once they are ready,
+//so the GPU is never waited on
+class FrameProfiler {
+
+public:
+	FrameProfiler(void);
+	~FrameProfiler(void);
+
+	//FrameProfiler is not meant to be copied or moved
+	FrameProfiler(const FrameProfiler &) = delete;
+	FrameProfiler(FrameProfiler &&) = delete;
+	FrameProfiler& operator=(const FrameProfiler &) = delete;
+	FrameProfiler& operator=(FrameProfiler&&) = delete;
+
+	bool Initialize(void); //needs an OpenGL context. Returns false if GPU timers are not supported - only the CPU is timed then
+
+	void BeginFrame(void); //ends the frame before
+
+	void BeginStage(ProfileStage stage);
+	void EndStage(ProfileStage stage);
+
+	//only one pass can be timed at a time
+	void BeginPass(ProfilePass pass);
+	void EndPass(ProfilePass pass);
+
+	//frames ago = 0 is the newest finished frame
+	unsigned int GetNumFrames(void) const;
+	const FrameTimes & GetFrame(unsigned int framesAgo) const;
+
+	//percentile p (0 - 1) of kept frames. Stage, pass & whole frame versions
+	float GetStagePercentile(ProfileStage stage, float p) const;
+	float GetPassPercentile(ProfilePass pass, float p) const;
+	float GetFramePercentile(float p) const;
+
+	static const char * GetStageName(ProfileStage stage);
+	static const char * GetPassName(ProfilePass pass);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	static float Percentile(std::vector<float> & times, float p); //ignores negative times
+	void ReadQueries(unsigned int set); //collects finished passes of query set - unfinished ones stay issued
+
+	std::vector<FrameTimes> m_frames; //ring buffer
+	unsigned int m_current; //frame being timed
+	unsigned int m_numFrames; //finished frames kept
+	Clock::time_point m_frameStart;
+
+	//open stages, innermost last
+	std::vector<std::pair<ProfileStage, Clock::time_point>> m_openStages;
+
+	//2 sets of GPU queries - one is issued while the other one finishes
+	bool m_gpuTiming;
+	GLuint m_queries[2][NUM_PASSES];
+	bool m_queryIssued[2][NUM_PASSES]; //waiting for result
+	unsigned int m_queryFrame[2][NUM_PASSES]; //frame in ring buffer query belongs to
+	unsigned int m_querySet; //set used for current frame
+	ProfilePass m_openPass; //NUM_PASSES while no pass is timed
+	unsigned int m_frameCount; //frames begun - tells which query set to use
+};
+
+//times a stage until end of scope
+class ProfileScope {
+
+public:
+	ProfileScope(FrameProfiler & profiler, ProfileStage stage);
+	~ProfileScope(void);
+
+	//ProfileScope is not meant to be copied or moved
+	ProfileScope(const ProfileScope &) = delete;
+	ProfileScope(ProfileScope &&) = delete;
+	ProfileScope& operator=(const ProfileScope &) = delete;
+	ProfileScope& operator=(ProfileScope&&) = delete;
+
+private:
+	FrameProfiler & m_profiler;
+	const ProfileStage m_stage;
+};
+
+//times a render pass on the GPU until end of scope
+class ProfilePassScope {
+
+public:
+	ProfilePassScope(FrameProfiler & profiler, ProfilePass pass);
+	~ProfilePassScope(void);
+
+	//ProfilePassScope is not meant to be copied or moved
+	ProfilePassScope(const ProfilePassScope &) = delete;
+	ProfilePassScope(ProfilePassScope &&) = delete;
+	ProfilePassScope& operator=(const ProfilePassScope &) = delete;
+	ProfilePassScope& operator=(ProfilePassScope&&) = delete;
+
+private:
+	FrameProfiler & m_profiler;
+	const ProfilePass m_pass;
+};
+
+#endif /* FRAMEPROFILER_H */
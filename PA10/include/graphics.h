@@ -7,6 +7,7 @@
 #include "shader.h"
 #include "objects/object.h"
 #include "configLoader.hpp"
+#include "frameProfiler.h"
 
 #include <SDL2/SDL.h>
 #include <vector>
@@ -15,7 +16,8 @@
 
 class Graphics {
 public:
-	Graphics(void);
+	Graphics(void) = delete;
+	Graphics(FrameProfiler & profiler);
 	~Graphics(void);
 
 	//initalizes for various parts of graphics class
@@ -23,7 +25,8 @@ public:
 	bool InitializeBt(const glm::vec3 & gravity);
 	bool InitializeLighting(const glm::vec3 & ambientLevel, const float shininess);
 
-	void Update(unsigned int dt);
+	void Update(float dt); //one physics & game logic step of dt seconds
+	void Interpolate(float alpha); //places objects alpha (0 - 1) of the way from the step before to the last step
 
 	void AddObject(const objectModel & obj);
 	bool VerifyObjects(void) const; //function to verify all pinball objects are in place
@@ -76,6 +79,7 @@ private:
 	std::string ErrorString(const GLenum error) const;
 
 	Camera * m_camera;
+	FrameProfiler & m_profiler;
 
 	//variables to keep track of shaders
 	std::vector<Shader *> m_shaders;
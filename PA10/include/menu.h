@@ -11,20 +11,28 @@
 
 #include "graphics.h"
 #include "scoreboard.h"
+#include "frameProfiler.h"
+#include "framePacer.h"
 #include <iostream>
 
 class Menu {
 
 public:
-	Menu(const glm::vec3 & eyeLoc, const glm::vec3 & eyeFocus, const glm::uvec2 & menuSize);
+	Menu(const glm::vec3 & eyeLoc, const glm::vec3 & eyeFocus, const glm::uvec2 & menuSize, bool ownWindow);
 	~Menu(void);
 
-	bool Initialize(const SDL_GLContext & gl_context, const Scoreboard * scoreboard);
-	bool Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEyeLoc, int lives, int score); //returns if menu has been undated
+	//menu is drawn over the main window, unless it was made with a window of its own
+	bool Initialize(SDL_Window * mainWindow, const SDL_GLContext & gl_context, const Scoreboard * scoreboard);
 
-	void HandleEvent(SDL_Event event);
+	//overlay is drawn into the frame of the main window, so it has to be updated before the main window is swapped
+	bool Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEyeLoc, int lives, int score, FrameProfiler & profiler,
+			const FramePacer & pacer); //returns if menu has been undated
 
-	SDL_Window * GetWindow(void);
+	//returns true if the menu used the event. Overlay leaves events it does not want to the game - key & button releases always
+	bool HandleEvent(SDL_Event event);
+
+	SDL_Window * GetWindow(void); //own window, or main window for the overlay
+	bool HasWindow(void) const;
 
 	glm::vec3 GetEyeLocation(void) const;
 	glm::vec3 GetEyeFocus(void) const;
@@ -32,6 +40,8 @@ public:
 
 private:
 	SDL_Window * m_window;
+	SDL_Window * m_mainWindow;
+	const bool m_ownWindow;
 
 	glm::vec3 m_eyeLoc;
 	glm::vec3 m_eyeFocus;
@@ -46,6 +56,7 @@ private:
 	std::string m_topTen[10];
 
 	void UpdateMenuParams(void);
+	void ShowProfiler(const FrameProfiler & profiler, const FramePacer & pacer); //p50/p99 of every stage & stacked graphs of the last frames
 
 };
 
@@ -27,14 +27,15 @@ public:
 	void setAngularVelocity(const glm::vec3 & vel, bool accumulate = false);
 	void scaleVelocities(float scale);
 
-	void Update(void);
+	void KeepStep(void); //keeps current transform as the one of the step before
+	void Interpolate(float alpha); //sets model alpha (0 - 1) of the way from the step before to the current transform
 	void Render(void);
 
 	glm::mat4 GetModel(void);
 
 	glm::vec3 GetTranslation(void) const;
 	void SetTranslation(const glm::vec3 & translation);
-	void ResetBt(const glm::vec3 & loc, const glm::vec3 & rotation);
+	void ResetBt(const glm::vec3 & loc, const glm::vec3 & rotation); //moves object without interpolating
 
 	glm::vec3 GetRotationAngles(void) const;
 	void SetRotationAngles(const glm::vec3 & rotation);
@@ -62,6 +63,10 @@ protected:
 private:
 	glm::mat4 m_model;
 
+	//transform of the step before
+	glm::vec3 m_stepTranslation;
+	glm::quat m_stepRotation;
+
 	std::vector<Vertex> m_vertices;
 	std::vector<std::vector<unsigned int>> m_indices; //holds indicy set for each texture
 
@@ -0,0 +1,66 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+//trace of what every thread is doing, written as Chrome trace events (open in chrome://tracing or ui.perfetto.dev)
+//only recorded when compiled with USE_TRACING - otherwise the macros below compile to nothing
+//names have to be string literals: only the pointer is kept
+
+#ifdef USE_TRACING
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+//events a thread can record - later ones are dropped (& counted) rather than growing without bound
+#define TRACE_CHUNK_EVENTS 4096
+#define TRACE_MAX_CHUNKS 256
+
+//times scope & records it as one event once it ends
+class TraceScope {
+
+public:
+	TraceScope(const char * name);
+	~TraceScope(void);
+
+	//TraceScope is not meant to be copied or moved
+	TraceScope(const TraceScope &) = delete;
+	TraceScope(TraceScope &&) = delete;
+	TraceScope& operator=(const TraceScope &) = delete;
+	TraceScope& operator=(TraceScope&&) = delete;
+
+private:
+	const char * m_name;
+	uint64_t m_start;
+};
+
+//every thread records into a buffer of its own, so recording never locks. Only the first event of a thread takes a lock
+void TraceBegin(const char * name); //begin & end markers - for spans that do not fit a scope
+void TraceEnd(const char * name);
+void TraceCounter(const char * name, double value);
+void TraceThreadName(const char * name);
+
+//writes every event recorded so far - can be called while other threads keep recording. Returns false if file could not be written
+bool TraceWrite(const std::string & fileName);
+
+#define TRACE_CONCAT_(a, b) a ## b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_BEGIN(name) TraceBegin(name)
+#define TRACE_END(name) TraceEnd(name)
+#define TRACE_COUNTER(name, value) TraceCounter(name, value)
+#define TRACE_THREAD_NAME(name) TraceThreadName(name)
+#define TRACE_WRITE(fileName) TraceWrite(fileName)
+
+#else
+
+#define TRACE_SCOPE(name)
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_COUNTER(name, value)
+#define TRACE_THREAD_NAME(name)
+#define TRACE_WRITE(fileName) false
+
+#endif /* USE_TRACING */
+
+#endif /* TRACE_H */
@@ -49,6 +49,30 @@ bool ConfigFileParser::getWindowInfo(std::string & windowName, glm::uvec2 & size
 	return true;
 }
 
+bool ConfigFileParser::getPacingInfo(PacingMode & mode, float & frameCap) {
+	std::string varName, modeName;
+	if (!parseLine < std::string > (varName, &modeName) || varName.compare("WINDOW_PACING")) {
+		printf("Could not get frame pacing from config file \n");
+		return false;
+	}
+
+	const char * modeNames[NUM_PACING_MODES] = { "UNCAPPED", "VSYNC", "ADAPTIVE", "CAPPED" };
+	unsigned int i = 0;
+	while (i < NUM_PACING_MODES && modeName.compare(modeNames[i]))
+		++i;
+	if (i == NUM_PACING_MODES) {
+		printf("Frame pacing in config file has to be UNCAPPED, VSYNC, ADAPTIVE or CAPPED \n");
+		return false;
+	}
+	mode = PacingMode(i);
+
+	if (!parseLine<float>(varName, &frameCap) || varName.compare("WINDOW_FRAME_CAP") || frameCap <= 0.f) {
+		printf("Could not get frame cap from config file \n");
+		return false;
+	}
+	return true;
+}
+
 bool ConfigFileParser::getCameraInfo(glm::vec3 & eyePos, glm::vec3 & eyeLoc) {
 	std::string varName;
 	float values[3];
@@ -106,7 +130,7 @@ bool ConfigFileParser::getShaderSetActive(std::string & set) {
 	return true;
 }
 
-bool ConfigFileParser::getMenuState(bool & menu, glm::uvec2 & size) {
+bool ConfigFileParser::getMenuState(bool & menu, glm::uvec2 & size, bool & ownWindow) {
 	std::string varName;
 	if (!parseLine<bool>(varName, &menu) || varName.compare("ENABLE_MENU")) {
 		printf("Could not get menu state from config file \n");
@@ -121,6 +145,12 @@ bool ConfigFileParser::getMenuState(bool & menu, glm::uvec2 & size) {
 	}
 	size = glm::uvec2(winSize[0], winSize[1]);
 
+	//menu is drawn over the main window unless it gets a window of its own
+	if (!parseLine<bool>(varName, &ownWindow) || varName.compare("MENU_WINDOW")) {
+		printf("Could not get menu window mode from config file \n");
+		return false;
+	}
+
 	return true;
 }
 
@@ -137,6 +167,23 @@ bool ConfigFileParser::getWorldGravity(glm::vec3 & gravity) {
 	return true;
 }
 
+bool ConfigFileParser::getPhysicsRate(float & rate, unsigned int & maxSteps) {
+	std::string varName;
+
+	//physics steps per second
+	if (!parseLine<float>(varName, &rate) || varName.compare("PHYSICS_RATE") || rate <= 0.f) {
+		printf("Could not get physics rate from config file \n");
+		return false;
+	}
+
+	//most steps taken in one frame
+	if (!parseLine<unsigned int>(varName, &maxSteps) || varName.compare("PHYSICS_MAX_STEPS") || !maxSteps) {
+		printf("Could not get max physics steps from config file \n");
+		return false;
+	}
+	return true;
+}
+
 bool ConfigFileParser::getLightingInfo(glm::vec3 & ambientLevel, float & shininess, std::vector<glm::vec3> & spotlightLocs) {
 	spotlightLocs.clear();
 	std::string varName;
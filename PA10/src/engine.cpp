@@ -1,12 +1,13 @@
 #include "engine.h"
+#include "trace.h"
 
 #include <chrono>
-#include <assert.h>
+#include <cmath>
 #include <iostream>
 
 Engine::Engine(const std::string & launchFile) :
-		m_window(nullptr), m_graphics(nullptr), m_menu(nullptr), m_menuLastTime(0), m_configFile(launchFile), m_DT(0), m_currentTimeMillis(
-				Engine::GetCurrentTimeMillis()), m_running(false), m_shift(false) {
+		m_window(nullptr), m_graphics(nullptr), m_pacer(nullptr), m_menu(nullptr), m_menuWindow(false), m_menuLastTime(0), m_configFile(launchFile), m_DT(0), m_running(false), m_physicsStep(
+				0), m_maxPhysicsSteps(0), m_shift(false) {
 	std::srand(time(nullptr));
 }
 
@@ -14,6 +15,7 @@ Engine::~Engine(void) {
 	delete m_window;
 	delete m_graphics;
 	delete m_menu;
+	delete m_pacer;
 }
 
 bool Engine::Initialize(void) {
@@ -31,17 +33,28 @@ bool Engine::Initialize(void) {
 		return false;
 	}
 
+	//start frame pacing - needs the OpenGL context of the window
+	PacingMode pacingMode;
+	float frameCap;
+	if (!m_configFile.getPacingInfo(pacingMode, frameCap)) {
+		printf("Could not get frame pacing from configuration file \n");
+		return false;
+	}
+	m_pacer = new FramePacer(pacingMode, frameCap);
+	m_pacer->Initialize();
+
 	glm::vec3 eyePos, eyeLoc;
 	if (!m_configFile.getCameraInfo(eyePos, eyeLoc)) {
 		printf("Could not get camera information from configuration file \n");
 		return false;
 	}
 	//start the graphics
-	m_graphics = new Graphics();
+	m_graphics = new Graphics(m_profiler);
 	if (!m_graphics->Initialize(m_window->GetWindowWidth(), m_window->GetWindowHeight(), eyePos, eyeLoc)) {
 		printf("The graphics failed to initialize.\n");
 		return false;
 	}
+	m_profiler.Initialize(); //GPU timers need OpenGL - runs without them if they are not supported
 
 	//add shader sets
 	std::string shaderSetName, shaderSrcVert, shaderSrcFrag;
@@ -56,7 +69,7 @@ bool Engine::Initialize(void) {
 
 	//check if menu needs to be initialized
 	bool menu;
-	if (!m_configFile.getMenuState(menu, m_menuSize)) {
+	if (!m_configFile.getMenuState(menu, m_menuSize, m_menuWindow)) {
 		printf("Could not get menu information from configuration file \n");
 		return false;
 	}
@@ -71,6 +84,12 @@ bool Engine::Initialize(void) {
 		printf("The graphics failed to initialize bullet.\n");
 		return false;
 	}
+	float physicsRate;
+	if (!m_configFile.getPhysicsRate(physicsRate, m_maxPhysicsSteps)) {
+		printf("Could not get physics rate from configuration file \n");
+		return false;
+	}
+	m_physicsStep = 1.0 / physicsRate;
 
 	//get lighting info
 	glm::vec3 ambientLevel;
@@ -110,22 +129,44 @@ bool Engine::Initialize(void) {
 void Engine::Run(void) {
 	m_running = true;
 
-	std::chrono::high_resolution_clock::time_point t1, t2;
-	const float FPS = 500; //FPS cap, should obviously add a way to change this later
-	const float minFrameTime = 1.0f / FPS * 1000;
-	float duration;
+	//simulated time lags real time by lag - it is made up in fixed steps, the part of a step left over is interpolated
+	std::chrono::steady_clock::time_point lastFrame = std::chrono::steady_clock::now();
+	double lag = 0.0;
 
+	TRACE_THREAD_NAME("Main");
 	while (m_running) {
+		TRACE_SCOPE("Frame");
 
-		t1 = std::chrono::high_resolution_clock::now();
+		m_profiler.BeginFrame();
 		SDL_GL_MakeCurrent(m_window->GetWindow(), m_window->GetContext());
 
-		EventChecker(); // Check for events input
+		{
+			ProfileScope scope(m_profiler, STAGE_EVENTS);
+			EventChecker(); // Check for events input
+		}
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		m_DT = std::chrono::duration<float, std::milli>(now - lastFrame).count();
+		lastFrame = now;
+		lag += m_DT / 1000.0;
 
-		m_DT = getDT();
 		// Update and render the graphics
-		m_graphics->Update(m_DT);
-		m_graphics->Render();
+		{
+			ProfileScope scope(m_profiler, STAGE_UPDATE);
+			for (unsigned int step = 0; step < m_maxPhysicsSteps && lag >= m_physicsStep; ++step) {
+				m_graphics->Update(m_physicsStep);
+				lag -= m_physicsStep;
+			}
+
+			//could not catch up - rest is dropped, so one slow frame does not make the next ones slower as well
+			if (lag >= m_physicsStep)
+				lag = std::fmod(lag, m_physicsStep);
+			m_graphics->Interpolate(lag / m_physicsStep);
+		}
+		{
+			ProfileScope scope(m_profiler, STAGE_RENDER);
+			m_graphics->Render();
+		}
 
 		//End the game if lives == 0
 		if (m_graphics->GetLives() < 1) {
@@ -152,12 +193,10 @@ void Engine::Run(void) {
 			m_running = false;
 			break;
 		}
-		// Swap to the Window
-		m_window->Swap();
-
-		//update menu and change variables if necessary
+		//update menu and change variables if necessary - before the swap, so the overlay is presented with the frame it is drawn over
 		if (m_running != false) {
-			if (m_menu && m_menu->Update(m_window->GetContext(), m_graphics->GetEyePos(), m_graphics->GetLives(), m_graphics->GetScore())) {
+			ProfileScope scope(m_profiler, STAGE_MENU);
+			if (m_menu && m_menu->Update(m_window->GetContext(), m_graphics->GetEyePos(), m_graphics->GetLives(), m_graphics->GetScore(), m_profiler, *m_pacer)) {
 				if (!m_graphics->UpdateCamera(m_menu->GetEyeLocation(), m_menu->GetEyeFocus())) {
 					printf("Error updating parameters from menu update. Shutting down /n");
 					m_running = false;
@@ -165,20 +204,19 @@ void Engine::Run(void) {
 			}
 
 		}
-		//enforce max frame rate
-		t2 = std::chrono::high_resolution_clock::now();
-		duration = std::chrono::duration_cast < std::chrono::milliseconds > (t2 - t1).count();
-		if (duration < minFrameTime)
-			SDL_Delay(minFrameTime - duration);
+
+		// Swap to the Window
+		{
+			ProfileScope scope(m_profiler, STAGE_SWAP);
+			m_window->Swap();
+		}
+
+		m_pacer->EndFrame();
 	}
-}
 
-unsigned int Engine::getDT(void) {
-	long long TimeNowMillis = Engine::GetCurrentTimeMillis();
-	assert(TimeNowMillis >= m_currentTimeMillis);
-	unsigned int DeltaTimeMillis = (unsigned int) (TimeNowMillis - m_currentTimeMillis);
-	m_currentTimeMillis = TimeNowMillis;
-	return DeltaTimeMillis;
+#ifdef USE_TRACING
+	WriteTrace();
+#endif
 }
 
 long long Engine::GetCurrentTimeMillis() {
@@ -206,10 +244,10 @@ void Engine::EventChecker(void) {
 		if (m_event.window.windowID == SDL_GetWindowID(m_window->GetWindow())) {
 			if (m_event.window.event == SDL_WINDOWEVENT_CLOSE) { //quits if main window is closed
 				m_running = false;
-			} else {
+			} else if (!m_menu || m_menu->HasWindow() || !m_menu->HandleEvent(m_event)) { //overlay menu gets first pick
 				HandleEvent(m_event);
 			}
-		} else if (m_menu && m_event.window.windowID == SDL_GetWindowID(m_menu->GetWindow())) {
+		} else if (m_menu && m_menu->HasWindow() && m_event.window.windowID == SDL_GetWindowID(m_menu->GetWindow())) {
 			if (m_event.window.event == SDL_WINDOWEVENT_CLOSE
 					|| (m_event.type == SDL_KEYDOWN && m_event.key.keysym.sym == SDLK_t && m_menuLastTime + 500 < Engine::GetCurrentTimeMillis()))
 				CloseMenu();
@@ -218,7 +256,8 @@ void Engine::EventChecker(void) {
 					|| m_event.key.keysym.sym == SDLK_UP || m_event.key.keysym.sym == SDLK_i || m_event.key.keysym.sym == SDLK_o
 					|| m_event.key.keysym.sym == SDLK_f || m_event.key.keysym.sym == SDLK_v || m_event.key.keysym.sym == SDLK_m
 					|| m_event.key.keysym.sym == SDLK_l || m_event.key.keysym.sym == SDLK_z || m_event.key.keysym.sym == SDLK_x
-					|| m_event.key.keysym.sym == SDLK_g || m_event.key.keysym.sym == SDLK_h || m_event.key.keysym.sym == SDLK_b)
+					|| m_event.key.keysym.sym == SDLK_g || m_event.key.keysym.sym == SDLK_h || m_event.key.keysym.sym == SDLK_b
+					|| m_event.key.keysym.sym == SDLK_F12)
 				HandleEvent(m_event);
 			else
 				m_menu->HandleEvent(m_event);
@@ -270,6 +309,8 @@ void Engine::HandleEvent(const SDL_Event & event) {
 			m_graphics->MovePaddleL(m_DT);
 		else if (event.key.keysym.sym == SDLK_b)
 			m_graphics->StartLife();
+		else if (event.key.keysym.sym == SDLK_F12)
+			WriteTrace();
 	} else if (event.type == SDL_KEYUP) {
 		if (event.key.keysym.sym == SDLK_g)
 			m_graphics->SetResetFlagPaddleL(true);
@@ -280,8 +321,8 @@ void Engine::HandleEvent(const SDL_Event & event) {
 }
 
 bool Engine::StartMenu(const glm::vec3 & eyePos, const glm::vec3 & eyeLoc) {
-	m_menu = new Menu(eyePos, eyeLoc, m_menuSize);
-	if (!m_menu->Initialize(m_window->GetContext(), &m_scoreboard)) {
+	m_menu = new Menu(eyePos, eyeLoc, m_menuSize, m_menuWindow);
+	if (!m_menu->Initialize(m_window->GetWindow(), m_window->GetContext(), &m_scoreboard)) {
 		printf("The imgui menu failed to initialize. Running without it. \n");
 		delete m_menu;
 		m_menu = nullptr;
@@ -291,6 +332,15 @@ bool Engine::StartMenu(const glm::vec3 & eyePos, const glm::vec3 & eyeLoc) {
 	return true;
 }
 
+void Engine::WriteTrace(void) {
+#ifdef USE_TRACING
+	if (!TRACE_WRITE(TRACE_FILE))
+		printf("\nCould not write trace to %s\n", TRACE_FILE);
+#else
+	printf("\nTracing is not compiled in - build with USE_TRACING=ON to record a trace\n");
+#endif
+}
+
 bool Engine::CloseMenu(void) {
 	delete m_menu;
 	m_menu = nullptr;
@@ -0,0 +1,95 @@
+#include "framePacer.h"
+#include "trace.h"
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <cstdio>
+
+FramePacer::FramePacer(PacingMode mode, float frameCap) :
+		m_mode(mode), m_frameCap(frameCap), m_framePeriod(
+				std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(frameCap, 1.f)))), m_started(false), m_frameTimes(
+				PACER_HISTORY, 0.f), m_current(0), m_numFrames(0) {
+}
+
+PacingMode FramePacer::Initialize(void) {
+	if (m_mode == PACING_ADAPTIVE && SDL_GL_SetSwapInterval(-1) < 0) {
+		printf("Adaptive vsync is not supported (%s) - using vsync\n", SDL_GetError());
+		m_mode = PACING_VSYNC;
+	}
+	if (m_mode == PACING_VSYNC && SDL_GL_SetSwapInterval(1) < 0) {
+		printf("Vsync is not supported (%s) - running uncapped\n", SDL_GetError());
+		m_mode = PACING_UNCAPPED;
+	}
+	if (m_mode == PACING_UNCAPPED || m_mode == PACING_CAPPED)
+		SDL_GL_SetSwapInterval(0);
+
+	m_started = false;
+	return m_mode;
+}
+
+void FramePacer::EndFrame(void) {
+	if (m_mode == PACING_CAPPED) {
+		TRACE_SCOPE("Pacing");
+
+		//frames are due on a fixed schedule so waits do not add up. A frame that is already late is presented right away & the schedule
+		//restarts from it, rather than waiting a whole extra period or rushing the frames after it
+		Clock::time_point now = Clock::now();
+		if (m_started && now < m_deadline + m_framePeriod) {
+			m_deadline += m_framePeriod;
+			WaitUntil(m_deadline);
+		} else {
+			m_deadline = now;
+		}
+	}
+
+	Clock::time_point now = Clock::now();
+	if (m_started) {
+		m_frameTimes[m_current] = std::chrono::duration<float, std::milli>(now - m_lastFrame).count();
+		m_current = (m_current + 1) % PACER_HISTORY;
+		m_numFrames = std::min(m_numFrames + 1, (unsigned int) PACER_HISTORY);
+	}
+	m_lastFrame = now;
+	m_started = true;
+}
+
+PacingMode FramePacer::GetMode(void) const {
+	return m_mode;
+}
+
+float FramePacer::GetFrameCap(void) const {
+	return m_frameCap;
+}
+
+FramePacing FramePacer::GetPacing(void) const {
+	FramePacing pacing;
+	pacing.m_mean = pacing.m_jitter = pacing.m_max = 0.f;
+	if (!m_numFrames)
+		return pacing;
+
+	double sum = 0.0, sumSquares = 0.0;
+	for (unsigned int i = 0; i < m_numFrames; ++i) {
+		sum += m_frameTimes[i];
+		sumSquares += double(m_frameTimes[i]) * m_frameTimes[i];
+		pacing.m_max = std::max(pacing.m_max, m_frameTimes[i]);
+	}
+	pacing.m_mean = sum / m_numFrames;
+	pacing.m_jitter = std::sqrt(std::max(0.0, sumSquares / m_numFrames - double(pacing.m_mean) * pacing.m_mean));
+	return pacing;
+}
+
+const char * FramePacer::GetModeName(PacingMode mode) {
+	static const char * names[NUM_PACING_MODES] = { "Uncapped", "Vsync", "Adaptive vsync", "Capped" };
+	return names[mode];
+}
+
+//sleeping alone can wake up late by up to a millisecond or more, spinning alone keeps a core busy for the whole wait
+void FramePacer::WaitUntil(Clock::time_point deadline) const {
+	Clock::time_point sleepUntil = deadline - std::chrono::microseconds(PACER_SPIN_MARGIN_US);
+	if (Clock::now() < sleepUntil)
+		std::this_thread::sleep_until(sleepUntil);
+
+	while (Clock::now() < deadline)
+		;
+}
@@ -0,0 +1,180 @@
+#include "frameProfiler.h"
+#include "trace.h"
+
+#include <algorithm>
+
+FrameProfiler::FrameProfiler(void) :
+		m_frames(PROFILER_HISTORY), m_current(0), m_numFrames(0), m_frameStart(Clock::now()), m_gpuTiming(false), m_querySet(0), m_openPass(
+				NUM_PASSES), m_frameCount(0) {
+	for (unsigned int set = 0; set < 2; ++set)
+		for (unsigned int pass = 0; pass < NUM_PASSES; ++pass) {
+			m_queries[set][pass] = 0;
+			m_queryIssued[set][pass] = false;
+			m_queryFrame[set][pass] = 0;
+		}
+}
+
+FrameProfiler::~FrameProfiler(void) {
+	if (m_gpuTiming)
+		glDeleteQueries(2 * NUM_PASSES, &m_queries[0][0]);
+}
+
+bool FrameProfiler::Initialize(void) {
+#if !defined(__APPLE__) && !defined(MACOSX)
+	if (!GLEW_VERSION_3_3 && !GLEW_ARB_timer_query) {
+		printf("GPU timers are not supported - only the CPU is profiled\n");
+		return false;
+	}
+#endif
+
+	glGenQueries(2 * NUM_PASSES, &m_queries[0][0]);
+	m_gpuTiming = true;
+	return true;
+}
+
+void FrameProfiler::BeginFrame(void) {
+	Clock::time_point now = Clock::now();
+
+	//finish frame before
+	if (m_frameCount) {
+		m_frames[m_current].m_frame = std::chrono::duration<float, std::milli>(now - m_frameStart).count();
+		m_numFrames = std::min(m_numFrames + 1, (unsigned int) PROFILER_HISTORY);
+		m_current = (m_current + 1) % PROFILER_HISTORY;
+	}
+	m_openStages.clear();
+
+	FrameTimes & frame = m_frames[m_current];
+	std::fill(frame.m_stages, frame.m_stages + NUM_STAGES, 0.f);
+	std::fill(frame.m_passes, frame.m_passes + NUM_PASSES, -1.f);
+	frame.m_frame = 0.f;
+	m_frameStart = now;
+
+	//queries of this set were issued 2 frames ago - they are usually done by now
+	m_querySet = m_frameCount & 1;
+	if (m_gpuTiming)
+		ReadQueries(m_querySet);
+	++m_frameCount;
+}
+
+void FrameProfiler::BeginStage(ProfileStage stage) {
+	m_openStages.emplace_back(stage, Clock::now());
+}
+
+void FrameProfiler::EndStage(ProfileStage stage) {
+	if (m_openStages.empty() || m_openStages.back().first != stage)
+		return;
+
+	float duration = std::chrono::duration<float, std::milli>(Clock::now() - m_openStages.back().second).count();
+	m_openStages.pop_back();
+
+	//time of a nested stage is taken out of the stage around it
+	m_frames[m_current].m_stages[stage] += duration;
+	if (!m_openStages.empty())
+		m_frames[m_current].m_stages[m_openStages.back().first] -= duration;
+}
+
+void FrameProfiler::BeginPass(ProfilePass pass) {
+	//query still busy from 2 frames ago - pass is not timed this frame rather than waiting on it
+	if (!m_gpuTiming || m_openPass != NUM_PASSES || m_queryIssued[m_querySet][pass])
+		return;
+
+	glBeginQuery(GL_TIME_ELAPSED, m_queries[m_querySet][pass]);
+	m_queryIssued[m_querySet][pass] = true;
+	m_queryFrame[m_querySet][pass] = m_current;
+	m_openPass = pass;
+}
+
+void FrameProfiler::EndPass(ProfilePass pass) {
+	//a pass that was not begun (e.g. another one was open) must not end the one that is timed
+	if (m_openPass != pass)
+		return;
+
+	glEndQuery (GL_TIME_ELAPSED);
+	m_openPass = NUM_PASSES;
+}
+
+unsigned int FrameProfiler::GetNumFrames(void) const {
+	return m_numFrames;
+}
+
+const FrameTimes & FrameProfiler::GetFrame(unsigned int framesAgo) const {
+	return m_frames[(m_current + PROFILER_HISTORY - 1 - framesAgo) % PROFILER_HISTORY];
+}
+
+float FrameProfiler::GetStagePercentile(ProfileStage stage, float p) const {
+	std::vector<float> times(m_numFrames);
+	for (unsigned int i = 0; i < m_numFrames; ++i)
+		times[i] = GetFrame(i).m_stages[stage];
+	return Percentile(times, p);
+}
+
+float FrameProfiler::GetPassPercentile(ProfilePass pass, float p) const {
+	std::vector<float> times(m_numFrames);
+	for (unsigned int i = 0; i < m_numFrames; ++i)
+		times[i] = GetFrame(i).m_passes[pass];
+	return Percentile(times, p);
+}
+
+float FrameProfiler::GetFramePercentile(float p) const {
+	std::vector<float> times(m_numFrames);
+	for (unsigned int i = 0; i < m_numFrames; ++i)
+		times[i] = GetFrame(i).m_frame;
+	return Percentile(times, p);
+}
+
+const char * FrameProfiler::GetStageName(ProfileStage stage) {
+	static const char * names[NUM_STAGES] = { "Events", "Update", "Physics", "Render", "Swap", "Menu" };
+	return names[stage];
+}
+
+const char * FrameProfiler::GetPassName(ProfilePass pass) {
+	static const char * names[NUM_PASSES] = { "Scene", "Menu" };
+	return names[pass];
+}
+
+float FrameProfiler::Percentile(std::vector<float> & times, float p) {
+	times.erase(std::remove_if(times.begin(), times.end(), [](float t) {return t < 0.f;}), times.end());
+	if (times.empty())
+		return 0.f;
+
+	std::vector<float>::iterator nth = times.begin() + std::min<size_t>(times.size() - 1, p * times.size());
+	std::nth_element(times.begin(), nth, times.end());
+	return *nth;
+}
+
+void FrameProfiler::ReadQueries(unsigned int set) {
+	for (unsigned int pass = 0; pass < NUM_PASSES; ++pass) {
+		if (!m_queryIssued[set][pass])
+			continue;
+
+		GLint available = 0;
+		glGetQueryObjectiv(m_queries[set][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			continue;
+
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(m_queries[set][pass], GL_QUERY_RESULT, &nanoseconds);
+		m_frames[m_queryFrame[set][pass]].m_passes[pass] = nanoseconds / 1e6f;
+		m_queryIssued[set][pass] = false;
+	}
+}
+
+ProfileScope::ProfileScope(FrameProfiler & profiler, ProfileStage stage) :
+		m_profiler(profiler), m_stage(stage) {
+	m_profiler.BeginStage(m_stage);
+	TRACE_BEGIN(FrameProfiler::GetStageName(m_stage)); //stages show up in the trace as well
+}
+
+ProfileScope::~ProfileScope(void) {
+	TRACE_END(FrameProfiler::GetStageName(m_stage));
+	m_profiler.EndStage(m_stage);
+}
+
+ProfilePassScope::ProfilePassScope(FrameProfiler & profiler, ProfilePass pass) :
+		m_profiler(profiler), m_pass(pass) {
+	m_profiler.BeginPass(m_pass);
+}
+
+ProfilePassScope::~ProfilePassScope(void) {
+	m_profiler.EndPass(m_pass);
+}
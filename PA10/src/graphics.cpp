@@ -1,8 +1,9 @@
 #include "graphics.h"
+#include "trace.h"
 #include <iostream>
 
-Graphics::Graphics(void) :
-		m_camera(nullptr), m_currentShader(-1), mbt_broadphase(nullptr), mbt_collisionConfig(nullptr), mbt_dispatcher(nullptr), mbt_solver(nullptr), mbt_dynamicsWorld(
+Graphics::Graphics(FrameProfiler & profiler) :
+		m_camera(nullptr), m_profiler(profiler), m_currentShader(-1), mbt_broadphase(nullptr), mbt_collisionConfig(nullptr), mbt_dispatcher(nullptr), mbt_solver(nullptr), mbt_dynamicsWorld(
 				nullptr), m_lightingStatus(false), m_ambientLevel(0.0, 0.0, 0.0), m_shininessConst(0), m_spotLightHeight(6), m_ball(-1), m_paddleR(
 				-1), m_paddleL(-1), m_board(-1), m_score(0), m_scoreLastObj(nullptr), m_lives(3), m_paddleRMoving(false), m_paddleLMoving(false) {
 	m_spotlightLocs.resize(1);
@@ -210,6 +211,7 @@ void Graphics::SetResetFlagPaddleL(bool flag) {
 }
 
 bool Graphics::AddShaderSet(const std::string & setName, const std::string & vertexShaderSrc, const std::string & fragmentShaderSrc) {
+	TRACE_SCOPE("Load shaders");
 	//Set up the shader
 	m_shaders.push_back(new Shader());
 	if (!m_shaders.back()->Initialize()) {
@@ -321,8 +323,15 @@ bool Graphics::UseShaderSet(const std::string & setName, bool hasLighting) {
 	return true;
 }
 
-void Graphics::Update(unsigned int dt) {
-	mbt_dynamicsWorld->stepSimulation(dt / 1000.f, 2000, btScalar(1.) / btScalar(200.));
+void Graphics::Update(float dt) {
+	//transforms before the step are kept to draw frames in between
+	for (Object * obj : m_objects)
+		obj->KeepStep();
+
+	{
+		ProfileScope scope(m_profiler, STAGE_PHYSICS);
+		mbt_dynamicsWorld->stepSimulation(dt, 0); //no substeps - step is already fixed
+	}
 
 	//update paddle locations
 	if (static_cast<Paddle *>(m_objects[m_paddleR])->GetResetFlag())
@@ -348,16 +357,22 @@ void Graphics::Update(unsigned int dt) {
 			trans.getRotation().getEulerZYX(newRotations.z, newRotations.y, newRotations.x);
 			obj->SetRotationAngles(newRotations);
 		}
-		obj->Update();
 	}
 }
 
+void Graphics::Interpolate(float alpha) {
+	for (Object * obj : m_objects)
+		obj->Interpolate(alpha);
+}
+
 bool Graphics::UpdateCamera(const glm::vec3 & eyePos, const glm::vec3 & eyeFocus) {
 	m_camera->UpdatePosition(eyePos, eyeFocus);
 	return true;
 }
 
 void Graphics::Render(void) {
+	ProfilePassScope pass(m_profiler, PASS_SCENE);
+
 //Clear the screen
 	glClearColor(0.0, 0.0, 0.0, 1.0);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -1,7 +1,21 @@
 #include "menu.h"
 
-Menu::Menu(const glm::vec3 & eyeLoc, const glm::vec3 & eyeFocus, const glm::uvec2 & menuSize) :
-		m_window(nullptr), m_eyeLoc(eyeLoc), m_eyeFocus(eyeFocus), m_menuSize(menuSize), m_menuTL(50, 50) {
+#include <algorithm>
+
+//size of profiler graphs
+#define PROFILER_GRAPH_HEIGHT 80.f
+
+//colors of profiler stages & passes in graphs - last stage color is time spent outside of stages
+static const ImU32 STAGE_COLORS[NUM_STAGES + 1] = { IM_COL32(230, 159, 0, 255), IM_COL32(86, 180, 233, 255), IM_COL32(0, 158, 115, 255), IM_COL32(
+		240, 228, 66, 255), IM_COL32(0, 114, 178, 255), IM_COL32(213, 94, 0, 255), IM_COL32(120, 120, 120, 255) };
+static const ImU32 PASS_COLORS[NUM_PASSES] = { IM_COL32(204, 121, 167, 255), IM_COL32(213, 94, 0, 255) };
+
+//draws one bar per kept frame, made of numParts parts stacked on top of each other. part(frame, i) gives time of part i
+static void PlotStacked(const char * label, const FrameProfiler & profiler, unsigned int numParts, float (*part)(const FrameTimes &, unsigned int),
+		const ImU32 * colors, float maxTime);
+
+Menu::Menu(const glm::vec3 & eyeLoc, const glm::vec3 & eyeFocus, const glm::uvec2 & menuSize, bool ownWindow) :
+		m_window(nullptr), m_mainWindow(nullptr), m_ownWindow(ownWindow), m_eyeLoc(eyeLoc), m_eyeFocus(eyeFocus), m_menuSize(menuSize), m_menuTL(50, 50) {
 	UpdateMenuParams();
 }
 
@@ -9,12 +23,20 @@ Menu::~Menu(void) {
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplSDL2_Shutdown();
 	ImGui::DestroyContext();
-	SDL_DestroyWindow (m_window);
+	if (m_ownWindow)
+		SDL_DestroyWindow (m_window);
 }
 
-bool Menu::Initialize(const SDL_GLContext & gl_context, const Scoreboard * scoreboard) {
+bool Menu::Initialize(SDL_Window * mainWindow, const SDL_GLContext & gl_context, const Scoreboard * scoreboard) {
 
-	m_window = SDL_CreateWindow("Menu", m_menuTL.y, m_menuTL.x, m_menuSize.y, m_menuSize.x, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+	m_mainWindow = m_window = mainWindow;
+	if (m_ownWindow) {
+		m_window = SDL_CreateWindow("Menu", m_menuTL.y, m_menuTL.x, m_menuSize.y, m_menuSize.x, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+		if (!m_window) {
+			printf("Could not create menu window: %s \n", SDL_GetError());
+			return false;
+		}
+	}
 
 	const char * glsl_version = "#version 330";
 
@@ -41,7 +63,7 @@ bool Menu::Initialize(const SDL_GLContext & gl_context, const Scoreboard * score
 
 }
 
-bool Menu::Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEyeLoc, int lives, int score) {
+bool Menu::Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEyeLoc, int lives, int score, FrameProfiler & profiler, const FramePacer & pacer) {
 
 	bool updated = false;
 
@@ -50,8 +72,15 @@ bool Menu::Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEy
 	ImGui_ImplSDL2_NewFrame (m_window);
 	ImGui::NewFrame();
 
-	ImGui::SetNextWindowPos(ImVec2(0.0, 0.0));
-	ImGui::SetNextWindowSize(ImVec2((m_menuSize.y) > 25 ? m_menuSize.y - 25 : 0, (m_menuSize.x) > 25 ? m_menuSize.x - 25 : 0));
+	if (m_ownWindow) {
+		ImGui::SetNextWindowPos(ImVec2(0.0, 0.0));
+		ImGui::SetNextWindowSize(ImVec2((m_menuSize.y) > 25 ? m_menuSize.y - 25 : 0, (m_menuSize.x) > 25 ? m_menuSize.x - 25 : 0));
+	} else {
+		//overlay starts in the top left corner & can be moved, resized or collapsed from there
+		ImGui::SetNextWindowPos(ImVec2(m_menuTL.y, m_menuTL.x), ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowSize(ImVec2(m_menuSize.y, m_menuSize.x), ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowBgAlpha(0.8f);
+	}
 	ImGui::Begin("Menu");
 
 	ImGui::Text("Use this section of the menu to move the camera around.");
@@ -83,27 +112,56 @@ bool Menu::Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEy
 
 	ImGui::Text("\n");
 	ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+
+	ImGui::Text("\n");
+	ShowProfiler(profiler, pacer);
 	ImGui::End();
 
 	// Rendering
 	ImGui::Render();
+	if (!m_ownWindow) { //over the scene - presented with it by the swap of the main window
+		ProfilePassScope pass(profiler, PASS_MENU);
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		return updated;
+	}
+
 	SDL_GL_MakeCurrent(m_window, gl_context);
-	glClearColor(0.0, 0.0, 0.2, 1.0);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-	SDL_GL_SwapWindow(m_window);
+	{
+		ProfilePassScope pass(profiler, PASS_MENU);
+		glClearColor(0.0, 0.0, 0.2, 1.0);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	}
+	{
+		ProfileScope scope(profiler, STAGE_SWAP);
+		SDL_GL_SwapWindow(m_window);
+	}
+	SDL_GL_MakeCurrent(m_mainWindow, gl_context);
 
 	return updated;
 }
 
-void Menu::HandleEvent(SDL_Event event) {
+bool Menu::HandleEvent(SDL_Event event) {
 	ImGui_ImplSDL2_ProcessEvent(&event);
+	if (m_ownWindow)
+		return true;
+
+	const ImGuiIO & io = ImGui::GetIO();
+	if (event.type == SDL_MOUSEMOTION || event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEWHEEL)
+		return io.WantCaptureMouse;
+	if (event.type == SDL_KEYDOWN || event.type == SDL_TEXTINPUT)
+		return io.WantCaptureKeyboard;
+	return false; //releases reach the game as well, so nothing is left held down
 }
 
 SDL_Window * Menu::GetWindow(void) {
 	return m_window;
 }
 
+bool Menu::HasWindow(void) const {
+	return m_ownWindow;
+}
+
 glm::vec3 Menu::GetEyeLocation(void) const {
 	return m_eyeLoc;
 }
@@ -126,3 +184,76 @@ void Menu::UpdateMenuParams(void) {
 	mn_eyeFocus[1] = m_eyeFocus.y;
 	mn_eyeFocus[2] = m_eyeFocus.z;
 }
+
+void Menu::ShowProfiler(const FrameProfiler & profiler, const FramePacer & pacer) {
+	if (!ImGui::CollapsingHeader("Frame Profiler", ImGuiTreeNodeFlags_DefaultOpen))
+		return;
+
+	//percentiles of every stage in the color of its graph
+	ImGui::Text("%-12s %8s %8s", "ms", "p50", "p99");
+	for (unsigned int i = 0; i < NUM_STAGES; ++i) {
+		ProfileStage stage = static_cast<ProfileStage>(i);
+		ImGui::TextColored(ImColor(STAGE_COLORS[i]), "%-12s %8.2f %8.2f", FrameProfiler::GetStageName(stage), profiler.GetStagePercentile(stage, 0.5f),
+				profiler.GetStagePercentile(stage, 0.99f));
+	}
+	for (unsigned int i = 0; i < NUM_PASSES; ++i) {
+		ProfilePass pass = static_cast<ProfilePass>(i);
+		ImGui::TextColored(ImColor(PASS_COLORS[i]), "GPU %-8s %8.2f %8.2f", FrameProfiler::GetPassName(pass), profiler.GetPassPercentile(pass, 0.5f),
+				profiler.GetPassPercentile(pass, 0.99f));
+	}
+	ImGui::Text("%-12s %8.2f %8.2f", "Frame", profiler.GetFramePercentile(0.5f), profiler.GetFramePercentile(0.99f));
+
+	//time from one presented frame to the next
+	FramePacing pacing = pacer.GetPacing();
+	if (pacer.GetMode() == PACING_CAPPED)
+		ImGui::Text("Pacing: %s at %.0f FPS", FramePacer::GetModeName(pacer.GetMode()), pacer.GetFrameCap());
+	else
+		ImGui::Text("Pacing: %s", FramePacer::GetModeName(pacer.GetMode()));
+	ImGui::Text("Frame time %.2f ms, jitter %.3f ms, worst %.2f ms", pacing.m_mean, pacing.m_jitter, pacing.m_max);
+
+	//both graphs use the same scale so CPU & GPU can be compared
+	float maxTime = std::max(1.f, profiler.GetFramePercentile(0.99f) * 1.25f);
+
+	//stages, then whatever is left of the frame (e.g. waiting on frame rate cap)
+	PlotStacked("CPU", profiler, NUM_STAGES + 1, [](const FrameTimes & frame, unsigned int i)->float {
+		if (i < NUM_STAGES)
+			return frame.m_stages[i];
+
+		float rest = frame.m_frame;
+		for (unsigned int s = 0; s < NUM_STAGES; ++s)
+			rest -= frame.m_stages[s];
+		return rest;
+	}, STAGE_COLORS, maxTime);
+
+	PlotStacked("GPU", profiler, NUM_PASSES, [](const FrameTimes & frame, unsigned int i)->float {
+		return frame.m_passes[i];
+	}, PASS_COLORS, maxTime);
+}
+
+static void PlotStacked(const char * label, const FrameProfiler & profiler, unsigned int numParts, float (*part)(const FrameTimes &, unsigned int),
+		const ImU32 * colors, float maxTime) {
+	ImGui::Text("%s (0 - %.1f ms)", label, maxTime);
+
+	ImVec2 origin = ImGui::GetCursorScreenPos();
+	ImVec2 size(ImGui::GetContentRegionAvailWidth(), PROFILER_GRAPH_HEIGHT);
+	ImDrawList * drawList = ImGui::GetWindowDrawList();
+	drawList->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), IM_COL32(30, 30, 30, 255));
+
+	//newest frame on the right
+	float barWidth = size.x / PROFILER_HISTORY;
+	for (unsigned int f = 0; f < profiler.GetNumFrames(); ++f) {
+		const FrameTimes & frame = profiler.GetFrame(f);
+		float x = origin.x + size.x - (f + 1) * barWidth;
+		float y = origin.y + size.y;
+
+		for (unsigned int i = 0; i < numParts && y > origin.y; ++i) {
+			float height = std::max(0.f, part(frame, i)) / maxTime * size.y;
+			float top = std::max(origin.y, y - height);
+			if (top < y)
+				drawList->AddRectFilled(ImVec2(x, top), ImVec2(x + barWidth, y), colors[i]);
+			y = top;
+		}
+	}
+
+	ImGui::Dummy(size);
+}
@@ -1,4 +1,5 @@
 #include "objects/object.h"
+#include "trace.h"
 
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -10,7 +11,8 @@
 
 Object::Object(const std::string & objFile, const glm::vec3 & traslation, const glm::vec3 & rotation, const glm::vec3 & scale) :
 		m_model(1.0), m_translation(traslation), m_rotationAngles(rotation), m_scale(scale), VB(0), mbt_rigidBody(nullptr), mbt_mesh(nullptr), mbt_shape(
-				nullptr) {
+				nullptr), m_stepTranslation(traslation), m_stepRotation(rotation) {
+	TRACE_SCOPE("Load object");
 
 	//vertex attributes: vec3 position, vec3 color, vec2 uv, vec3 normal
 	if (!loadObjAssimp(objFile)) {
@@ -107,20 +109,17 @@ void ::Object::scaleVelocities(float scale) {
 	}
 }
 
-void Object::Update(void) {
-
-#if 0
-	glm::mat4 rotationMat = glm::rotate((m_rotationAngles.x), glm::vec3(1.0, 0.0, 0.0)) * glm::rotate((m_rotationAngles.z), glm::vec3(0.0, 0.0, 1.0))
-	* glm::rotate((m_rotationAngles.y), glm::vec3(0.0, 1.0, 0.0));
+void Object::KeepStep(void) {
+	m_stepTranslation = m_translation;
+	m_stepRotation = glm::quat(m_rotationAngles);
+}
 
-	m_model = glm::translate(m_translation) * rotationMat * glm::scale(m_scale);
-#else
-	glm::mat4 translate = glm::translate(glm::mat4(1.0), m_translation);
-	glm::mat4 rotate = glm::mat4_cast(glm::quat(m_rotationAngles));
+void Object::Interpolate(float alpha) {
+	glm::mat4 translate = glm::translate(glm::mat4(1.0), glm::mix(m_stepTranslation, m_translation, alpha));
+	glm::mat4 rotate = glm::mat4_cast(glm::slerp(m_stepRotation, glm::quat(m_rotationAngles), alpha));
 	glm::mat4 scale = glm::scale(glm::mat4(1.0), m_scale);
 
 	m_model = translate * rotate * scale;
-#endif
 }
 
 void Object::Render(void) {
@@ -183,6 +182,7 @@ void Object::ResetBt(const glm::vec3 & loc, const glm::vec3 & rotation) {
 	}
 	SetTranslation(loc);
 	SetRotationAngles(rotation);
+	KeepStep();
 }
 
 glm::vec3 Object::GetRotationAngles(void) const {
@@ -281,6 +281,7 @@ bool Object::loadObjAssimp(const std::string & objFile) {
 }
 
 void Object::loadTextures(const std::string & objFile, const std::vector<aiString> & textureFiles) {
+	TRACE_SCOPE("Load textures");
 	GLuint tempTexture;
 	Magick::Image * img;
 	std::string fileNameStart = "";
@@ -52,11 +52,7 @@ bool Window::Initialize(const std::string & name, unsigned int height, unsigned
 		return false;
 	}
 
-	// Use VSync
-	if (SDL_GL_SetSwapInterval(1) < 0) {
-		printf("Unable to use VSync: %s\n", SDL_GetError());
-		return false;
-	}
+	//swap interval is left to the frame pacer
 	return true;
 }
 
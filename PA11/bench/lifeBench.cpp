@@ -0,0 +1,235 @@
+//headless benchmark of the simulation - loads board layout from a configuration file and runs generations without a window
+
+#include "configLoader.hpp"
+#include "neighborTable.h"
+#include "lifeSimulation.h"
+#include "lifeAI.h"
+#include "cubeBoard.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+//number of power of 2 buckets in latency histogram - last bucket holds everything slower
+#define LATENCY_BUCKETS 24
+
+typedef struct BenchSettings {
+	std::string m_launchFile;
+	unsigned int m_generations;
+	unsigned int m_warmup; //generations run before timing starts
+	unsigned int m_seed;
+	float m_density; //chance of element starting alive
+	int m_threads; //-1 = use value from configuration file
+	unsigned int m_edge; //elements along each edge of a generated cube board. 0 = use board from configuration file
+	unsigned int m_aiBudget; //milliseconds the computer player gets to find a move on the final board. 0 = computer player is not run
+} BenchSettings;
+
+//function to parse command line arguments
+bool GetSettings(int argc, char * argv[], BenchSettings & settings);
+
+//loads board layout & simulation settings - rest of the file is skipped over in order
+void LoadGame(const std::string & launchFile, GameInfo & game);
+
+void PrintHistogram(const std::vector<double> & latencies);
+
+int main(int argc, char * argv[]) {
+	BenchSettings settings;
+	if (!GetSettings(argc, argv, settings)) {
+		std::cerr << "Error getting paramter values " << std::endl;
+		return -1;
+	}
+
+	try {
+		GameInfo game;
+		LoadGame(settings.m_launchFile, game);
+		if (settings.m_threads >= 0)
+			game.m_simulationThreads = settings.m_threads;
+		if (settings.m_edge)
+			GenerateCubeBoard(settings.m_edge, game.m_boardSpacing, game.m_sides);
+
+		NeighborTable neighborTable(game.m_sides);
+		LifeSimulation simulation(neighborTable, game.m_simulationThreads);
+		simulation.SetRule(game.m_rule);
+		const unsigned int numElements = neighborTable.GetNumElements();
+
+		//seed board - same seed gives the same board on every machine
+		std::mt19937 rng(settings.m_seed);
+		std::uniform_real_distribution<float> chance(0.f, 1.f);
+		for (unsigned int i = 0; i < numElements; ++i) {
+			if (chance(rng) < settings.m_density)
+				simulation.SetElement(i, (chance(rng) < 0.5f) ? P1_ALIVE : P2_ALIVE);
+		}
+
+		//types are double buffered like the board does when playing
+		std::vector<ObjType> types[2] = { std::vector<ObjType>(numElements, DEAD), std::vector<ObjType>(numElements, DEAD) };
+
+		printf("Board: %u elements, %u threads, rule %s, seed %u, density %.3f\n", numElements, simulation.GetNumThreads(),
+				LifeRuleToString(game.m_rule).c_str(), settings.m_seed, settings.m_density);
+
+		for (unsigned int g = 0; g < settings.m_warmup; ++g) {
+			simulation.Step();
+			simulation.WriteTypes(&types[g & 1][0], 2);
+		}
+
+		std::vector<double> latencies; //nanoseconds of each generation
+		latencies.reserve(settings.m_generations);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int g = 0; g < settings.m_generations; ++g) {
+			std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+			simulation.Step();
+			simulation.WriteTypes(&types[(settings.m_warmup + g) & 1][0], 2);
+			std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+			latencies.push_back(std::chrono::duration<double, std::nano>(t2 - t1).count());
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		//checksum of final board - changes if the rules produce a different result
+		uint64_t checksum = 14695981039346656037ull; //FNV-1a
+		unsigned int population = 0;
+		for (unsigned int i = 0; i < numElements; ++i) {
+			checksum = (checksum ^ (simulation.IsAlive(i) ? 1 : 0)) * 1099511628211ull;
+			population += simulation.IsAlive(i);
+		}
+
+		double cells = double(numElements) * settings.m_generations;
+		printf("\n%u generations in %.3f s\n", settings.m_generations, seconds);
+		printf("generations/s: %.1f\n", settings.m_generations / seconds);
+		printf("cells/s:       %.3e\n", cells / seconds);
+		printf("ns/cell:       %.4f\n", seconds * 1e9 / cells);
+		printf("active rows:   %u\n", simulation.GetNumActiveRows());
+		printf("population:    %u\n", population);
+		printf("checksum:      %016llx\n", (unsigned long long) checksum);
+
+		PrintHistogram(latencies);
+
+		//computer player scores moves on copies of the final board - stresses copying & stepping on every thread at once
+		if (settings.m_aiBudget) {
+			simulation.WriteTypes(&types[0][0]);
+			LifeAI ai(neighborTable, game.m_simulationThreads, game.m_aiLookahead, settings.m_aiBudget);
+
+			start = std::chrono::steady_clock::now();
+			AIMove move = ai.FindMove(simulation, &types[0][0], true);
+			seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			printf("\ncomputer player: %u moves scored in %.3f s, %u generations ahead\n", ai.GetMovesScored(), seconds, game.m_aiLookahead);
+			printf("moves/s:       %.1f\n", ai.GetMovesScored() / seconds);
+			printf("cells/s:       %.3e\n", double(numElements) * game.m_aiLookahead * ai.GetMovesScored() / seconds);
+			printf("best move:     %u marks, lead %i\n", move.m_numMarks, move.m_score);
+		}
+	} catch (std::string & err) {
+		std::cerr << std::endl << "The benchmark crashed: " << err << std::endl;
+		return -1;
+	} catch (...) {
+		std::cerr << std::endl << "The benchmark crashed! Error is unknown " << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+bool GetSettings(int argc, char * argv[], BenchSettings & settings) {
+	settings.m_launchFile = "launch/DefaultConfig.txt";
+	settings.m_generations = 1000;
+	settings.m_warmup = 10;
+	settings.m_seed = 1;
+	settings.m_density = 0.3f;
+	settings.m_threads = -1;
+	settings.m_edge = 0;
+	settings.m_aiBudget = 0;
+
+	for (int i = 1; i < argc; i += 2) {
+		if (argv[i][0] != '-' || argv[i][1] == '\0' || argv[i][2] != '\0' || i + 1 >= argc) {
+			std::cout << std::endl << "Could not understand command line arguments!" << std::endl
+					<< "Flags: -l <config file> -g <generations> -w <warmup generations> -s <seed> -d <density> -t <threads> -e <board edge> -a <AI milliseconds>. See README.MD"
+					<< std::endl;
+			return false;
+		}
+
+		switch (argv[i][1]) {
+		case 'l':
+			settings.m_launchFile = argv[i + 1];
+			break;
+		case 'g':
+			settings.m_generations = std::strtoul(argv[i + 1], nullptr, 10);
+			break;
+		case 'w':
+			settings.m_warmup = std::strtoul(argv[i + 1], nullptr, 10);
+			break;
+		case 's':
+			settings.m_seed = std::strtoul(argv[i + 1], nullptr, 10);
+			break;
+		case 'd':
+			settings.m_density = std::strtof(argv[i + 1], nullptr);
+			break;
+		case 't':
+			settings.m_threads = std::atoi(argv[i + 1]);
+			break;
+		case 'e':
+			settings.m_edge = std::strtoul(argv[i + 1], nullptr, 10);
+			break;
+		case 'a':
+			settings.m_aiBudget = std::strtoul(argv[i + 1], nullptr, 10);
+			break;
+		default:
+			std::cout << std::endl << "Unknown flag: " << argv[i] << std::endl;
+			return false;
+		}
+	}
+
+	return settings.m_generations > 0;
+}
+
+void LoadGame(const std::string & launchFile, GameInfo & game) {
+	ConfigFileParser configFile(launchFile);
+
+	std::string windowName;
+	glm::uvec2 size;
+	configFile.GetWindowInfo(windowName, size);
+
+	PacingMode pacingMode;
+	float frameCap;
+	configFile.GetPacingInfo(pacingMode, frameCap);
+
+	glm::vec3 eyePos, eyeLoc;
+	configFile.GetCameraInfo(eyePos, eyeLoc);
+
+	bool menu, menuWindow;
+	configFile.GetMenuState(menu, size, menuWindow);
+
+	configFile.GetGameInfo(game);
+}
+
+//histogram of generation latency in power of 2 microsecond buckets, with percentiles
+void PrintHistogram(const std::vector<double> & latencies) {
+	unsigned int buckets[LATENCY_BUCKETS] = { };
+	for (double ns : latencies) {
+		unsigned int b = 0;
+		while (b + 1 < LATENCY_BUCKETS && ns >= 1000.0 * (1u << b))
+			++b;
+		++buckets[b];
+	}
+
+	std::vector<double> sorted(latencies);
+	std::sort(sorted.begin(), sorted.end());
+	auto percentile = [&sorted](double p)->double {
+		return sorted[std::min<size_t>(sorted.size() - 1, p * sorted.size())] / 1000.0;
+	};
+
+	printf("\nlatency per generation (us): min %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n", sorted.front() / 1000.0, percentile(0.5),
+			percentile(0.9), percentile(0.99), sorted.back() / 1000.0);
+
+	unsigned int maxCount = *std::max_element(buckets, buckets + LATENCY_BUCKETS);
+	for (unsigned int b = 0; b < LATENCY_BUCKETS; ++b) {
+		if (!buckets[b])
+			continue;
+
+		double low = (b == 0) ? 0.0 : double(1u << (b - 1));
+		printf("%10.0f - %-10s us | %-40s %u\n", low, (b + 1 == LATENCY_BUCKETS) ? "inf" : std::to_string(1u << b).c_str(),
+				std::string(40 * buckets[b] / maxCount, '#').c_str(), buckets[b]);
+	}
+}
@@ -3,9 +3,22 @@
 
 #include "object.h"
 #include "shader.h"
+#include "neighborTable.h"
+#include "lifeSimulation.h"
+#include "lifeRecording.h"
+#include "generationHistory.h"
+#include "cycleDetector.h"
+#include "lifeAI.h"
 #include <iostream>
+#include <mutex>
+#include <condition_variable>
 
-#include <btBulletDynamicsCommon.h>
+//texture unit of buffer texture holding types of all game elements - unit 0 holds the texture array of types
+#define TYPE_TEXTURE_UNIT 1
+//changed elements closer than this are uploaded in one call
+#define TYPE_UPLOAD_MERGE_GAP 256
+//furthest distance an element can be picked at
+#define PICK_DISTANCE 1000.f
 
 class Board {
 
@@ -24,8 +37,10 @@ public:
 	void AddShaderSet(const std::string & setName, const std::string & vertexShaderSrc, const std::string & fragmentShaderSrc);
 	void UseShaderSet(const std::string & setName);
 
-	void Update(void);
+	void Update(void); //call at start of frame - picks up newest generation for rendering
 	void Render(void);
+	void PickUpGeneration(void); //makes newest generation the one rendered & uploads elements that changed. Only call from main thread
+	bool HasNewGeneration(void) const; //true while a published generation has not been picked up
 
 	//for changing lighting
 	void ChangeAmbientLight(const glm::vec3 & change);
@@ -36,28 +51,67 @@ public:
 	//for updating the bindings of uniforms
 	void UpdateCameraBindings(const glm::mat4 & viewMat, const glm::mat4 & projectionMat, const glm::vec3 & cameraPos);
 	void UpdateLightBindings(void);
-	void UpdateInstanceBindings(Object * obj);
-
-	const btDiscreteDynamicsWorld * GetBulletWorld(void) const;
 
 	//functions to interface with game elements
 	//uvec3: {face - BoardSides enumeration, row, column}
-	glm::uvec3 GetGameElementByPosition(const glm::vec3 & position) const;
+	glm::uvec3 GetGameElementByRay(const glm::vec3 & start, const glm::vec3 & direction) const; //closest element hit by ray
 	std::vector<glm::uvec3> GetGameElementNeighbors(const glm::uvec3 & element) const;
 	ObjType GetGameElementType(const glm::uvec3 & element) const;
 	void SetGameElementType(const glm::uvec3 & element, const ObjType type = ObjType::DEAD);
 	glm::uvec3 GetNextGameElement(const glm::uvec3 & currentElement) const;
 
+	//flat index versions - see NeighborTable for layout
+	const NeighborTable & GetNeighborTable(void) const;
+	unsigned int GetNumGameElements(void) const;
+	ObjType GetGameElementType(unsigned int index) const;
+	void SetGameElementType(unsigned int index, const ObjType type = ObjType::DEAD);
+
+	//computes next generation (or plays it back from a replay) into back buffer and publishes it. Only call from generation thread
+	//returns false if nothing was published because the replay is done - the replay is stopped & the next call simulates again
+	bool StepGeneration(void);
+
+	//saving & playing back games - see lifeRecording.h. Only call while no generation is being computed
+	void SaveSnapshot(const std::string & fileName, uint64_t generation) const;
+	uint64_t LoadSnapshot(const std::string & fileName); //returns generation snapshot was saved on
+	void StartRecording(const std::string & fileName, uint64_t generation); //log every change from now on
+	void StopRecording(void);
+	bool IsRecording(void) const;
+	uint64_t StartReplay(const std::string & fileName); //board is set to start of log. Returns generation log starts on
+	void StopReplay(void);
+	bool IsReplaying(void) const;
+
+	//going back in time - see generationHistory.h. Only call while no generation is being computed
+	//goes back to generation (or the oldest one kept) & returns the generation gone back to. Stops replay & recording
+	uint64_t RewindTo(uint64_t generation);
+	uint64_t GetOldestGeneration(void) const;
+
+	//generations until newest generation repeats - 0 = it does not within CYCLE_MAX_PERIOD. See cycleDetector.h
+	unsigned int GetPeriod(void) const;
+	void ClearHistory(uint64_t generation); //history restarts at current board as generation
+
+	//move of the computer player for player 1 or player 2 - see lifeAI.h. Only call while no generation is being computed
+	AIMove FindAIMove(bool player2);
+	unsigned int GetAIMovesScored(void) const; //moves scored for the last move found
+
+	//statistics of newest generation - kept up to date on every change, so they cost nothing to read
 	glm::uvec2 GetScore(void) const;
+	unsigned int GetTypeCount(const ObjType type) const;
+
+	//population {player 1, player 2} of every generation since last clear. Only call from main thread
+	const std::vector<glm::uvec2> & GetPopulationHistory(void) const;
+	void ClearPopulationHistory(void); //history restarts at current generation
 
 private:
 	void EnforceBounds(glm::vec3 & v, float min = 0.f, float max = 1.f); //rounds everything to be in range [min, max]
 
-	void InitializeBullet(void); //start bullet world
-	void LoadColliders(void); //loads one side of game board
-	void AddCubeColliderToWorld(const glm::vec3 & position, const glm::vec3 & rotation, const glm::vec3 & scale); //adds cube collider to bullet world
+	void FindChangedTypes(unsigned int from, unsigned int to); //ranges of elements that differ between type buffers & type counts of to
+	glm::uvec2 GetPopulation(unsigned int buffer) const;
+	void RefreshTypes(void); //rewrites & uploads types of every element after simulation was changed as a whole
+	void EditElement(unsigned int index, const ObjType type); //changes simulation, history, cycle detector & log - not the types
+	void PublishGeneration(void);
 
-	void FindElementNeighborsInFace(std::vector<glm::uvec3> & neighbors, const glm::uvec3 & element) const; //helper function to get neighbors in same side as object
+	//distance along ray to closest element of face hit. Returns false if no element is hit
+	bool RaycastFace(unsigned int face, const glm::vec3 & start, const glm::vec3 & direction, float & distance, glm::uvec2 & element) const;
 
 	Object * m_sides[BoardSides::NUM_SIDES];
 
@@ -75,26 +129,46 @@ private:
 	GLint m_diffuseProduct;
 	GLint m_specularProduct;
 	GLint m_shininess;
+	GLint m_faceQuads;
 	glm::vec3 m_ambientLevel;
 	glm::vec3 m_diffuseLevel;
 	glm::vec3 m_specularLevel;
 	float m_shininessConst;
+	bool m_faceQuadsConst; //elements are drawn as quads facing the inside of the board with back faces culled, instead of whole objects
 	glm::vec3 m_spotlightLoc;
 
-	//for instancing
-	GLint m_instanceChangeRow;
-	GLint m_instanceChangeCol;
-	GLint m_instanceNumPerRow;
-	GLint m_samplers;
-	GLint m_sampleTypes; //type of texture to use on each object
-
-	//bullet variables - needed for ray casting
-	btBroadphaseInterface * m_broadphase;
-	btDefaultCollisionConfiguration * m_collisionConfiguration;
-	btCollisionDispatcher * m_dispatcher;
-	btSequentialImpulseConstraintSolver * m_solver;
-	btDiscreteDynamicsWorld * m_dynamicsWorld;
-	std::vector<btRigidBody*> m_rigidBodies;
+	//state of every game element - indexed by flat index of neighbor table
+	NeighborTable m_neighborTable;
+	//render-facing types - derived from simulation after every generation
+	//front buffer is rendered while the next generation is written to the back buffer, then they are swapped
+	std::vector<ObjType> m_types[2];
+	std::atomic<unsigned int> m_publishedTypes; //buffer with newest generation
+	std::atomic<unsigned int> m_frontTypes; //buffer being rendered
+	std::mutex m_frontMutex;
+	std::condition_variable m_frontCondition; //signaled when renderer picks up a new generation
+	std::vector<glm::uvec2> m_changedTypes[2]; //[begin, end) of elements that changed from the generation before
+	unsigned int m_typeCounts[2][ObjType::NUM_TYPES]; //number of elements of each type in each buffer
+	std::vector<glm::uvec2> m_populationHistory;
+	LifeSimulation m_simulation;
+	GenerationHistory m_history; //for rewinding
+	CycleDetector m_cycleDetector;
+	LifeAI m_ai;
+	std::vector<uint32_t> m_changeIndices; //elements changed by the last generation & their new states
+	std::vector<uint8_t> m_changeStates;
+	std::vector<uint32_t> m_editIndices; //edits replayed before the next generation & their states
+	std::vector<uint8_t> m_editStates;
+	GenerationLog * m_log; //nullptr when not recording
+	GenerationReplay * m_replay; //nullptr when not replaying
+
+	//for instancing - all elements of all faces are drawn with one call. Faces share one mesh (see mesh.h), the first one draws it
+	GLuint m_instanceBuffer;
+	GLint m_stateSampler;
+	GLint m_typeSampler;
+
+	//types of all game elements on the GPU - one byte per element read as a buffer texture, indexed by flat index
+	GLuint m_typeBuffer;
+	GLuint m_typeTexture;
+
 };
 
 #endif /* BOARD_H */
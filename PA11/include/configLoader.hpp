@@ -1,7 +1,8 @@
 #ifndef CONFIGLOADER_HPP
 #define CONFIGLOADER_HPP
 
-#include "graphics_headers.h"
+#include "gameInfo.h"
+#include "framePacer.h"
 
 #include <sstream>
 #include <vector>
@@ -21,9 +22,11 @@ public:
 
 	void GetWindowInfo(std::string & windowName, glm::uvec2 & size);
 
+	void GetPacingInfo(PacingMode & mode, float & frameCap);
+
 	void GetCameraInfo(glm::vec3 & eyePos, glm::vec3 & eyeLoc);
 
-	void GetMenuState(bool & menu, glm::uvec2 & size);
+	void GetMenuState(bool & menu, glm::uvec2 & size, bool & ownWindow);
 
 	void GetGameInfo(GameInfo & game);
 
@@ -0,0 +1,14 @@
+#ifndef CUBEBOARD_H
+#define CUBEBOARD_H
+
+#include "gameInfo.h"
+
+//smallest edge a cube board can have - every face needs at least one element
+#define CUBE_BOARD_MIN_EDGE 3
+
+//lays out the faces of a cube board with edge elements along every edge of the cube, spacing apart
+//every element sits on one point of the lattice covering the surface of the cube. Points on an edge or corner of the cube belong to
+//exactly one face, the same way for every edge length - an edge of 21 gives the faces of the original board (19x19, 21x20, ...)
+void GenerateCubeBoard(unsigned int edge, float spacing, BoardInfo (&sides)[BoardSides::NUM_SIDES]);
+
+#endif /* CUBEBOARD_H */
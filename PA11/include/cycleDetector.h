@@ -0,0 +1,44 @@
+#ifndef CYCLEDETECTOR_H
+#define CYCLEDETECTOR_H
+
+#include "lifeSimulation.h"
+
+//longest period found - hashes of this many generations are kept
+#define CYCLE_MAX_PERIOD 32
+
+//finds boards that stopped changing (period 1) or repeat every few generations
+//the board is hashed as the XOR of a random 64 bit key for every living element & its owner (Zobrist hashing)
+//so the hash is updated from the elements that changed instead of going over the whole board
+//a generation only depends on the one before, so once a board repeats it keeps repeating with the same period
+class CycleDetector {
+
+public:
+	CycleDetector(void);
+	~CycleDetector(void);
+
+	//CycleDetector is not meant to be copied or moved
+	CycleDetector(const CycleDetector &) = delete;
+	CycleDetector(CycleDetector &&) = delete;
+	CycleDetector& operator=(const CycleDetector &) = delete;
+	CycleDetector& operator=(CycleDetector&&) = delete;
+
+	void Reset(const LifeSimulation & simulation, unsigned int numElements); //hashes whole board & forgets generations before
+	void AddEdit(unsigned int index, uint8_t oldState, uint8_t newState); //call when an element is changed by hand
+	//call right after stepping with the changes of the step (see LifeSimulation::GetChanges)
+	void AddGeneration(const LifeSimulation & simulation, const std::vector<uint32_t> & indices, const std::vector<uint8_t> & states);
+	//board went back generations - hash is taken from the ones kept. Returns false if they are not kept, then Reset has to be called
+	bool Rewind(unsigned int generations);
+
+	unsigned int GetPeriod(void) const; //generations until board repeats - 0 = no repeat found within CYCLE_MAX_PERIOD
+	uint64_t GetHash(void) const;
+
+private:
+	static uint64_t GetKey(unsigned int index, uint8_t state); //0 for dead elements
+
+	uint64_t m_hash;
+	uint64_t m_hashes[CYCLE_MAX_PERIOD]; //hashes of generations before, [m_numGenerations % CYCLE_MAX_PERIOD] is the oldest
+	unsigned int m_numGenerations; //generations hashed since reset
+	unsigned int m_period;
+};
+
+#endif /* CYCLEDETECTOR_H */
@@ -5,11 +5,17 @@
 #include "window.h"
 #include "graphics.h"
 #include "configLoader.hpp"
+#include "framePacer.h"
+
+#include <chrono>
+
+//Chrome trace written on F12 & on exit - relative to the working directory. Only with USE_TRACING
+#define TRACE_FILE "trace.json"
 
 class Engine {
 public:
 	Engine(void) = delete;
-	Engine(const std::string & launchFile, float frameCap = 100);
+	Engine(const std::string & launchFile);
 	~Engine(void);
 
 	//Engine is not meant to be copied or moved
@@ -21,7 +27,7 @@ public:
 	void Run(void);
 
 private:
-	unsigned int GetDT(void);
+	float GetDT(void); //milliseconds since last call
 	static long long GetCurrentTimeMillis(void);
 
 	void EventChecker(void);
@@ -30,8 +36,11 @@ private:
 	bool StartMenu(const glm::vec3 & eyePos, const glm::vec3 & eyeLoc);
 	bool CloseMenu(void);
 
+	void WriteTrace(void);
+
 	Window * m_window;
 	Graphics * m_graphics;
+	FramePacer * m_pacer;
 	ConfigFileParser m_configFile; //used to get parameters from
 
 	bool m_shift; //keeps track of shift being pressed
@@ -49,13 +58,12 @@ private:
 
 	Menu * m_menu;
 	glm::uvec2 m_menuSize;
+	bool m_menuWindow; //menu gets a window of its own instead of being drawn over the game
 	long long m_menuLastTime; // last time when menu was created or destoryed
 
-	unsigned int m_dt;
-	long long m_currentTimeMillis;
+	float m_dt;
+	std::chrono::steady_clock::time_point m_lastFrame;
 	bool m_running;
-
-	const float m_minFrameTime; //for max frame rate
 };
 
 #endif // ENGINE_H
@@ -0,0 +1,76 @@
+#ifndef GAMEINFO_H
+#define GAMEINFO_H
+
+//types describing the game & board - kept free of OpenGL so the simulation can be built without a window
+
+// GLM
+#define GLM_FORCE_RADIANS
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include "lifeRule.h"
+
+#include <string>
+#include <cstdint>
+
+//one byte per type so types can be uploaded to the GPU as is
+enum ObjType : uint8_t {
+	DEAD = 0,
+	P1_ALIVE_FUTURE = 1,
+	P2_ALIVE_FUTURE = 2,
+	P1_ALIVE = 3,
+	P2_ALIVE = 4,
+	P1_DEAD_FUTURE = 5,
+	P2_DEAD_FUTURE = 6,
+	P1_ALIVE_MARKED = 7,
+	P2_ALIVE_MARKED = 8,
+	P1_DEAD_MARKED = 9,
+	P2_DEAD_MARKED = 10,
+  NUM_TYPES
+};
+
+enum BoardSides{
+	FLOOR = 0,
+	ROOF = 1,
+	NORTH = 2,
+	SOUTH = 3,
+	EAST = 4,
+	WEST = 5,
+	NUM_SIDES
+};
+
+typedef struct ObjectInfo {
+	std::string m_objFile;
+	glm::vec3 m_scale;
+	glm::vec3 m_rotation;
+	glm::vec3 m_diffuseLevel;
+	glm::vec3 m_specularLevel;
+	float m_shininess;
+	bool m_faceQuads; //draw one quad per element facing the inside of the board instead of the whole object
+} ObjectInfo;
+
+typedef struct BoardInfo {
+	std::string m_name;
+	glm::uvec2 m_size;
+	glm::vec3 m_startingLoc;
+	glm::vec3 m_changeRow;
+	glm::vec3 m_changeCol;
+} BoardInfo;
+
+typedef struct GameInfo {
+	ObjectInfo m_object;
+	std::string m_textures[ObjType::NUM_TYPES];
+	glm::vec3 m_ambientLevel;
+	unsigned int m_boardEdge; //elements along each edge of a cube board. 0 = sides are given one by one
+	float m_boardSpacing; //distance between elements of a cube board
+	BoardInfo m_sides[BoardSides::NUM_SIDES];
+	unsigned int m_simulationThreads; //0 = one per hardware thread
+	LifeRule m_rule;
+	float m_autoplayRate; //generations per second while autoplaying. 0 = as fast as possible
+	unsigned int m_historySize; //megabytes kept for rewinding. 0 = no rewinding
+	unsigned int m_aiLookahead; //generations the computer player looks ahead
+	unsigned int m_aiTimeBudget; //milliseconds the computer player spends finding a move
+} GameInfo;
+
+#endif /* GAMEINFO_H */
@@ -0,0 +1,86 @@
+#ifndef GENERATIONHISTORY_H
+#define GENERATIONHISTORY_H
+
+#include "lifeSimulation.h"
+
+#include <deque>
+#include <vector>
+
+//generations between keyframes - a keyframe costs a copy of the planes, a delta only the elements that changed
+#define HISTORY_KEYFRAME_INTERVAL 64
+
+//recent generations kept for rewinding, in a ring buffer of fixed size - oldest entries are dropped when it is full
+//every generation is stored as the XOR of its elements against the generation before (only elements that changed)
+//& edits made by hand between generations the same way. Stepping back flips the elements of one delta, so it costs the size of the delta
+//keyframes hold the planes of a whole generation. They are taken every HISTORY_KEYFRAME_INTERVAL generations, so rewinding far
+//can start from a keyframe instead of going through every delta, and the oldest generation kept always has one to start from
+class GenerationHistory {
+
+public:
+	GenerationHistory(void) = delete;
+	GenerationHistory(const NeighborTable & neighborTable, size_t capacity); //capacity in bytes. 0 = no history
+	~GenerationHistory(void);
+
+	//GenerationHistory is not meant to be copied or moved
+	GenerationHistory(const GenerationHistory &) = delete;
+	GenerationHistory(GenerationHistory &&) = delete;
+	GenerationHistory& operator=(const GenerationHistory &) = delete;
+	GenerationHistory& operator=(GenerationHistory&&) = delete;
+
+	void Clear(const LifeSimulation & simulation, uint64_t generation); //history starts at current generation
+	void AddEdit(unsigned int index, uint8_t toggle); //call when an element is changed by hand - toggle = old state ^ new state
+	//call right after stepping with the changes of the step (see LifeSimulation::GetChanges)
+	void AddGeneration(const LifeSimulation & simulation, const std::vector<uint32_t> & indices, const std::vector<uint8_t> & states);
+
+	//goes back one generation - edits made since are undone as well. Returns false if the generation before is not kept
+	bool StepBack(LifeSimulation & simulation);
+	//goes back to generation (or the oldest kept). Starts from a keyframe if that is cheaper than stepping back through every delta
+	void RewindTo(LifeSimulation & simulation, uint64_t generation);
+
+	uint64_t GetGeneration(void) const; //generation of the simulation
+	uint64_t GetOldestGeneration(void) const; //oldest generation that can be rewound to
+	size_t GetSize(void) const; //bytes used
+
+private:
+	enum EntryKind {
+		HISTORY_KEYFRAME = 0, //planes of a generation (LifePlane order) right after it was stepped
+		HISTORY_GENERATION = 1, //elements that changed in a step
+		HISTORY_EDIT = 2 //elements changed by hand after a step
+	};
+
+	//entry data is in the ring buffer at [m_offset, m_offset + m_size)
+	//keyframe: rows of every plane of every face. Delta: m_numChanges flat indices (uint32_t), then m_numChanges toggles (uint8_t)
+	typedef struct HistoryEntry {
+		size_t m_offset;
+		size_t m_size;
+		EntryKind m_kind;
+		unsigned int m_numChanges;
+		uint64_t m_generation; //generation entry belongs to
+	} HistoryEntry;
+
+	//space for a new entry after the newest one - drops oldest entries to make room. nullptr if size does not fit at all
+	uint8_t * Allocate(size_t size);
+	void AddDelta(EntryKind kind, uint64_t generation, const std::vector<uint32_t> & indices, const std::vector<uint8_t> & toggles);
+	void AddKeyframe(const LifeSimulation & simulation, uint64_t generation);
+	void RestoreKeyframe(LifeSimulation & simulation, const HistoryEntry & entry) const; //sets current & last planes
+	void ToggleEntry(LifeSimulation & simulation, const HistoryEntry & entry) const; //flips elements of a delta in current generation
+	void FlushEdits(void);
+	void DropOldDeltas(void); //oldest entry has to be a keyframe so the generation before the oldest delta can be rebuilt
+
+	const NeighborTable & m_neighborTable;
+	size_t m_keyframeSize;
+
+	std::vector<uint8_t> m_buffer; //ring buffer - never grows
+	std::deque<HistoryEntry> m_entries; //oldest first
+	uint64_t m_generation;
+
+	//edits since the last entry
+	std::vector<uint32_t> m_editIndices;
+	std::vector<uint8_t> m_editToggles;
+
+	//reused so adding & stepping back do not allocate
+	std::vector<uint32_t> m_changeIndices;
+	std::vector<uint8_t> m_changeToggles;
+};
+
+#endif /* GENERATIONHISTORY_H */
@@ -4,8 +4,12 @@
 #include "camera.h"
 #include "board.h"
 #include <chrono>
+#include <mutex>
+#include <condition_variable>
 
-#include <BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
+//files games are saved to & played back from - relative to the working directory
+#define SNAPSHOT_FILE "snapshot.pa11"
+#define GENERATION_LOG_FILE "generations.pa11log"
 
 class Graphics {
 public:
@@ -23,7 +27,7 @@ public:
 	void AddShaderSet(const std::string & setName, const std::string & vertexShaderSrc, const std::string & fragmentShaderSrc);
 	void UseShaderSet(const std::string & setName);
 
-	void Update(unsigned int dt);
+	void Update(float dt);
 	void Render(void);
 
 	//for movement for camera
@@ -66,12 +70,29 @@ public:
 	void StartAutoplay(void);
 	void StopAutoplay(void);
 
+	//saving & playing back games - errors are printed and leave the board as it was
+	void SaveSnapshot(void);
+	void LoadSnapshot(void);
+	void ToggleRecording(void); //logs every generation & edit to GENERATION_LOG_FILE
+	void ToggleReplay(void); //plays GENERATION_LOG_FILE back one generation at a time instead of simulating
+
+	//goes back generations (as far as the history allows). Generations gone back over are simulated again when going forward
+	void Rewind(unsigned int generations);
+
+	//player 2 is played by the computer in multiplayer games - see lifeAI.h
+	void ToggleAIOpponent(void);
+
 private:
 	std::string ErrorString(const GLenum error) const;
 
 	void UpdateCameraBindings(void); //updates bindings for camera in shader - need to call for camera change to take effect
 
-	glm::vec3 GetPositionUnder(const glm::vec2 & mousePosition); //raycast and find position mouse is pointing at
+	glm::uvec3 GetElementUnder(const glm::vec2 & mousePosition); //raycast and find game element mouse is pointing at
+
+	void GenerationWorker(void); //loop of persistent generation thread
+	void AutoplayWorker(void); //loop of autoplay thread - requests generations at a fixed rate
+	void WaitForGeneration(void); //blocks until requested generation is done. Only call from main thread
+	void PlayAIMove(void); //marks elements for player 2
 
 	Camera m_camera;
 
@@ -86,12 +107,20 @@ private:
 	bool m_hasPlacedNewCell; // True if player has used up their placement of cell
 	bool m_hasMarkedEnemyCell; // True if player has marked an enemy cell for death
 	int m_ownCellsKilled; // Used to see if player has marked two of their own cells for death before creating a new cell
+	bool m_isAIOpponent; // True if player 2 is played by the computer
 
 	glm::uvec2 m_screenSize; //required for calculating mouse position in 3d space
 
-	std::thread* m_generationThread;
-	std::thread* m_autoplayThread;
-	float m_autoplayInterval;
+	//generations are computed on one persistent thread - woken up whenever a new generation is requested
+	std::thread m_generationThread;
+	std::mutex m_generationMutex;
+	std::condition_variable m_generationCondition;
+	bool m_generationRequested;
+	bool m_generationShutdown;
+
+	//autoplay thread waits on generation condition as well
+	std::thread m_autoplayThread;
+	std::chrono::steady_clock::duration m_autoplayInterval; //0 = as fast as possible
 	std::atomic<bool> m_calculatingGeneration;
 	std::atomic<bool> m_isAutoplaying;
 };
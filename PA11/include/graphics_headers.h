@@ -11,13 +11,8 @@
 //#include <GL/glu.h>
 #endif
 
-// GLM
-#define GLM_FORCE_RADIANS
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/glm.hpp>
-#include <glm/ext.hpp>
+#include "gameInfo.h"
 
-#include <string>
 #include <thread>
 #include <atomic>
 
@@ -33,54 +28,16 @@ typedef struct Vertex {
 	}
 } Vertex;
 
-enum ObjType {
-	DEAD = 0,
-	P1_ALIVE_FUTURE = 1,
-	P2_ALIVE_FUTURE = 2,
-	P1_ALIVE = 3,
-	P2_ALIVE = 4,
-	P1_DEAD_FUTURE = 5,
-	P2_DEAD_FUTURE = 6,
-	P1_ALIVE_MARKED = 7,
-	P2_ALIVE_MARKED = 8,
-	P1_DEAD_MARKED = 9,
-	P2_DEAD_MARKED = 10,
-  NUM_TYPES
-};
+//per instance attributes of a game element - whole board is drawn with one instanced call
+typedef struct InstanceData {
+	glm::vec3 m_offset; //world position of element
+	glm::vec3 m_faceNormal; //normal of face element is on - points to the inside of the board
+	uint32_t m_element; //flat index of element - used to look up type
 
-enum BoardSides{
-	FLOOR = 0,
-	ROOF = 1,
-	NORTH = 2,
-	SOUTH = 3,
-	EAST = 4,
-	WEST = 5,
-	NUM_SIDES
-};
-
-typedef struct ObjectInfo {
-	std::string m_objFile;
-	glm::vec3 m_scale;
-	glm::vec3 m_rotation;
-	glm::vec3 m_diffuseLevel;
-	glm::vec3 m_specularLevel;
-	float m_shininess;
-} ObjectInfo;
-
-typedef struct BoardInfo {
-	std::string m_name;
-	glm::uvec2 m_size;
-	glm::vec3 m_startingLoc;
-	glm::vec3 m_changeRow;
-	glm::vec3 m_changeCol;
-} BoardInfo;
-
-typedef struct GameInfo {
-	ObjectInfo m_object;
-	std::string m_textures[ObjType::NUM_TYPES];
-	glm::vec3 m_ambientLevel;
-	BoardInfo m_sides[BoardSides::NUM_SIDES];
-} GameInfo;
+	InstanceData(const glm::vec3 & offset, const glm::vec3 & faceNormal, uint32_t element) :
+			m_offset(offset), m_faceNormal(faceNormal), m_element(element) {
+	}
+} InstanceData;
 
 typedef struct BasicTransform {
             glm::vec3 m_pos;
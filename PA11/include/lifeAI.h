@@ -0,0 +1,70 @@
+#ifndef LIFEAI_H
+#define LIFEAI_H
+
+#include "lifeSimulation.h"
+
+#include <memory>
+
+//own elements considered for marking for death - every pair of them is tried with every birth
+#define AI_SACRIFICE_CANDIDATES 6
+//dead elements considered for birth
+#define AI_BIRTH_CANDIDATES 24
+//moves scored at once per thread - moves are scored in order of how promising they look until time runs out
+#define AI_BATCH_PER_THREAD 4
+
+//one change a move makes: element (flat index) & the marked type it is set to
+typedef struct AIMark {
+	unsigned int m_element;
+	ObjType m_type;
+} AIMark;
+
+//move of a multiplayer turn: mark 2 own elements for death & 1 dead element for life, or mark 1 opponent element for death
+typedef struct AIMove {
+	AIMark m_marks[3];
+	unsigned int m_numMarks; //0 = no legal move
+	int m_score; //own population - opponent population after lookahead
+} AIMove;
+
+//computer player for multiplayer games
+//legal moves are scored by playing them on copies of the board & stepping those a few generations ahead
+//moves are scored in parallel, each thread stepping its own copy, so scoring does not allocate
+class LifeAI {
+
+public:
+	LifeAI(void) = delete;
+	//lookahead = generations stepped to score a move. timeBudget = milliseconds spent finding a move
+	LifeAI(const NeighborTable & neighborTable, unsigned int numThreads, unsigned int lookahead, unsigned int timeBudget);
+	~LifeAI(void);
+
+	//LifeAI is not meant to be copied or moved
+	LifeAI(const LifeAI &) = delete;
+	LifeAI(LifeAI &&) = delete;
+	LifeAI& operator=(const LifeAI &) = delete;
+	LifeAI& operator=(LifeAI&&) = delete;
+
+	//best move found within the time budget. types = types shown on the board, decide which elements can be marked
+	AIMove FindMove(const LifeSimulation & simulation, const ObjType * types, bool player2);
+
+	unsigned int GetMovesScored(void) const; //by last FindMove - for benchmarking
+
+private:
+	void FindCandidates(const LifeSimulation & simulation, const ObjType * types, bool player2);
+	unsigned int CountLivingNeighbors(const LifeSimulation & simulation, unsigned int index) const;
+	int ScoreMove(const LifeSimulation & simulation, const AIMove & move, bool player2, LifeSimulation & scratch) const;
+
+	const NeighborTable & m_neighborTable;
+	unsigned int m_lookahead;
+	unsigned int m_timeBudget;
+
+	ThreadPool m_threadPool;
+	std::vector<std::unique_ptr<LifeSimulation>> m_scratch; //one copy of the board per thread
+
+	std::vector<AIMove> m_candidates; //most promising first
+	std::vector<AIMove> m_kills; //moves killing an opponent element
+	std::vector<AIMove> m_trades; //moves giving up 2 own elements for a new one
+	std::vector<int> m_scores;
+	std::vector<std::pair<int, unsigned int>> m_ranking; //reused while finding candidates
+	unsigned int m_movesScored;
+};
+
+#endif /* LIFEAI_H */
@@ -0,0 +1,137 @@
+#ifndef LIFERECORDING_H
+#define LIFERECORDING_H
+
+#include "lifeSimulation.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+//snapshot file: SnapshotHeader, then for every face, for every plane (LifePlane order), for every row: GetRowWords(face) words
+//generation log: LogHeader, then LogRecords each followed by its changes - see GenerationLog
+//numbers are stored in native byte order & every part starts on 8 bytes, so files can be mapped and read in place
+#define SNAPSHOT_MAGIC "PA11SNAP"
+#define SNAPSHOT_VERSION 1
+#define GENERATION_LOG_MAGIC "PA11GLOG"
+#define GENERATION_LOG_VERSION 1
+
+typedef struct SnapshotHeader {
+	char m_magic[8];
+	uint32_t m_version;
+	uint32_t m_numFaces;
+	uint32_t m_faceSizes[BoardSides::NUM_SIDES][2]; //{rows, columns}
+	uint64_t m_generation;
+	uint64_t m_dataOffset; //byte of first plane word
+} SnapshotHeader;
+
+typedef struct LogHeader {
+	char m_magic[8];
+	uint32_t m_version;
+	uint32_t m_numElements;
+} LogHeader;
+
+enum LogRecordKind {
+	LOG_GENERATION = 0, //changes made by stepping one generation
+	LOG_EDIT = 1 //changes made by hand between generations
+};
+
+//followed by m_numChanges flat indices (uint32_t), m_numChanges states (LIFE_STATE_ bits, uint8_t) & zero padding to 8 bytes
+typedef struct LogRecord {
+	uint64_t m_generation; //generation the changes were made on
+	uint32_t m_kind;
+	uint32_t m_numChanges;
+} LogRecord;
+
+//saves planes of the current & last generation, so types derived after loading match the ones shown when saving
+void WriteSnapshot(const std::string & fileName, const LifeSimulation & simulation, const NeighborTable & neighborTable, uint64_t generation);
+//maps the file & copies the planes in - returns the generation saved with it
+uint64_t ReadSnapshot(const std::string & fileName, LifeSimulation & simulation, const NeighborTable & neighborTable);
+
+//read only memory mapping of a whole file
+class MappedFile {
+
+public:
+	MappedFile(void) = delete;
+	MappedFile(const std::string & fileName);
+	~MappedFile(void);
+
+	//MappedFile is not meant to be copied or moved
+	MappedFile(const MappedFile &) = delete;
+	MappedFile(MappedFile &&) = delete;
+	MappedFile& operator=(const MappedFile &) = delete;
+	MappedFile& operator=(MappedFile&&) = delete;
+
+	const uint8_t * GetData(void) const;
+	size_t GetSize(void) const;
+
+private:
+	const uint8_t * m_data;
+	size_t m_size;
+};
+
+//append only log of elements changed by every generation & by hand
+//starts with an edit record holding every living element, so a log can be replayed from an empty board
+class GenerationLog {
+
+public:
+	GenerationLog(void) = delete;
+	GenerationLog(const std::string & fileName, const LifeSimulation & simulation, unsigned int numElements, uint64_t generation);
+	~GenerationLog(void); //writes pending edits
+
+	//GenerationLog is not meant to be copied or moved
+	GenerationLog(const GenerationLog &) = delete;
+	GenerationLog(GenerationLog &&) = delete;
+	GenerationLog& operator=(const GenerationLog &) = delete;
+	GenerationLog& operator=(GenerationLog&&) = delete;
+
+	//edits are collected & written as one record before the next generation
+	void AddEdit(unsigned int index, uint8_t state);
+	//call right after stepping with the changes of the step (see LifeSimulation::GetChanges)
+	void AddGeneration(const std::vector<uint32_t> & indices, const std::vector<uint8_t> & states);
+
+private:
+	void WriteRecord(LogRecordKind kind, const std::vector<uint32_t> & indices, const std::vector<uint8_t> & states);
+
+	std::ofstream m_file;
+	uint64_t m_generation; //counted up by every generation added
+
+	std::vector<uint32_t> m_editIndices;
+	std::vector<uint8_t> m_editStates;
+};
+
+//plays back a generation log without simulating - reads records in place from the mapped file
+class GenerationReplay {
+
+public:
+	GenerationReplay(void) = delete;
+	GenerationReplay(const std::string & fileName, unsigned int numElements);
+	~GenerationReplay(void);
+
+	//GenerationReplay is not meant to be copied or moved
+	GenerationReplay(const GenerationReplay &) = delete;
+	GenerationReplay(GenerationReplay &&) = delete;
+	GenerationReplay& operator=(const GenerationReplay &) = delete;
+	GenerationReplay& operator=(GenerationReplay&&) = delete;
+
+	//clears the simulation & applies edits up to the first generation
+	void Start(LifeSimulation & simulation);
+	//hands out edits made by hand before the next generation - the caller applies them like its own edits, then calls NextGeneration
+	//returns false once log is done: edits no generation follows (made after the last one) are never handed out
+	//the edits & the generation are checked first, so a bad record throws before anything is handed out
+	bool NextEdits(std::vector<uint32_t> & indices, std::vector<uint8_t> & states);
+	void NextGeneration(LifeSimulation & simulation); //plays back the generation following the edits handed out
+
+	uint64_t GetGeneration(void) const; //generation of the last record applied
+
+private:
+	const LogRecord * PeekRecord(size_t position) const; //nullptr at end of log or on a record that was not written completely
+	const LogRecord * ReadEdits(size_t & position, uint64_t & generation, std::vector<uint32_t> & indices, std::vector<uint8_t> & states) const;
+	void CheckRecord(const LogRecord * record) const; //throws if a change is outside of the board
+
+	MappedFile m_file;
+	unsigned int m_numElements;
+	size_t m_position; //byte of next record
+	uint64_t m_generation;
+};
+
+#endif /* LIFERECORDING_H */
@@ -0,0 +1,24 @@
+#ifndef LIFERULE_H
+#define LIFERULE_H
+
+#include <string>
+#include <cstdint>
+
+//rule of the original game
+#define LIFE_DEFAULT_RULE "B3/S23"
+//neighbor counts a rule can name (0 - 8)
+#define LIFE_RULE_COUNTS 9
+
+//life-like rule in B/S notation, e.g. "B36/S23": dead elements with 3 or 6 alive neighbors come alive, alive ones with 2 or 3 stay alive
+//new elements always take the color most of their alive neighbors have (player 2 on a tie)
+typedef struct LifeRule {
+	uint16_t m_birth; //bit n set = dead element with n alive neighbors comes alive
+	uint16_t m_survival; //bit n set = alive element with n alive neighbors stays alive
+	uint8_t m_table[2][LIFE_RULE_COUNTS]; //[alive][alive neighbors] = alive in next generation - built from the masks
+} LifeRule;
+
+//throws if rule can not be read. Rules with B0 are not supported - every dead region would come alive at once
+LifeRule ParseLifeRule(const std::string & rule);
+std::string LifeRuleToString(const LifeRule & rule);
+
+#endif /* LIFERULE_H */
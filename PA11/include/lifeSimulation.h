@@ -0,0 +1,162 @@
+#ifndef LIFESIMULATION_H
+#define LIFESIMULATION_H
+
+#include "neighborTable.h"
+#include "threadPool.h"
+#include "lifeRule.h"
+
+//rough number of plane words stepped by one task - faces are split into bands of rows this size
+#define LIFE_TILE_WORDS 2048
+//rough number of edge elements stepped by one task
+#define LIFE_SEAM_TILE_ELEMENTS 1024
+//when more than this percent of rows changed in the last generation every row is stepped without checking for activity
+#define LIFE_FULL_SWEEP_PERCENT 50
+
+//number of 64 bit words processed together by the step kernel - one SSE2 register or one AVX2 register (see USE_AVX2 in CMakeLists.txt)
+#if defined(__AVX2__)
+#define LIFE_LANES 4
+#else
+#define LIFE_LANES 2
+#endif
+
+//planes stored for each generation - used to save & load the simulation
+enum LifePlane {
+	ALIVE_PLANE = 0, //element is alive
+	OWNER_PLANE = 1, //element belongs to player 2
+	ALIVE_LAST_PLANE = 2, //alive plane of generation before
+	OWNER_LAST_PLANE = 3, //owner plane of generation before
+	NUM_PLANES
+};
+
+//state of an element packed in one byte: bit 0 = alive, bit 1 = belongs to player 2
+#define LIFE_STATE_ALIVE 1
+#define LIFE_STATE_PLAYER2 2
+
+//simulation core of the game - every face is stored as packed bitplanes (1 bit per element)
+//alive plane: element is alive. owner plane: element belongs to player 2 (only set where alive)
+//interior elements are stepped 64 * LIFE_LANES at a time with bitsliced adders, elements on the edge of a face are stepped with the neighbor table
+//a step is split into tiles run on a thread pool: bands of rows first, then the edge elements once all bands are done
+//rows whose neighborhood did not change in the last generation are skipped, so still and dead regions cost (almost) nothing
+class LifeSimulation {
+
+public:
+	LifeSimulation(void) = delete;
+	LifeSimulation(const NeighborTable & neighborTable, unsigned int numThreads); //0 threads = one per hardware thread
+	~LifeSimulation(void);
+
+	//LifeSimulation is not meant to be copied or moved
+	LifeSimulation(const LifeSimulation &) = delete;
+	LifeSimulation(LifeSimulation &&) = delete;
+	LifeSimulation& operator=(const LifeSimulation &) = delete;
+	LifeSimulation& operator=(LifeSimulation&&) = delete;
+
+	//updates state of element from the type shown on the board - future & marked types are resolved to what they will become
+	void SetElement(unsigned int index, const ObjType type);
+	bool IsAlive(unsigned int index) const;
+	void Clear(void); //every element dead in current & last generation
+
+	void Step(void); //compute next generation
+
+	//rule used by following steps - see lifeRule.h. Starts out as LIFE_DEFAULT_RULE
+	void SetRule(const LifeRule & rule);
+	const LifeRule & GetRule(void) const;
+
+	//makes this simulation the same as other (rule included) - both have to be built from the same neighbor table. Does not allocate
+	void CopyFrom(const LifeSimulation & other);
+	glm::uvec2 GetPopulation(void) const; //living elements {player 1, player 2}
+
+	//derive render-facing types of every element from the last step - types must have room for all elements
+	//if types already holds what was written generationsAgo steps back, rows that did not change since are skipped. 0 = write everything
+	void WriteTypes(ObjType * types, unsigned int generationsAgo = 0) const;
+
+	unsigned int GetNumActiveRows(void) const; //rows that changed in the last step
+
+	//elements that changed in the last step with their new state - costs time proportional to rows that changed
+	void GetChanges(std::vector<uint32_t> & indices, std::vector<uint8_t> & states) const;
+	//advances one generation by applying changes found by GetChanges instead of stepping
+	void ApplyChanges(const uint32_t * indices, const uint8_t * states, unsigned int numChanges);
+	uint8_t GetState(unsigned int index) const;
+	uint8_t GetLastState(unsigned int index) const; //state in the generation before
+
+	//for going back in time - toggles are LIFE_STATE_ bits to flip (XOR of two states)
+	void ToggleElements(const uint32_t * indices, const uint8_t * toggles, unsigned int numToggles); //flips elements like SetElement
+	//undoes the last step: the generation before becomes the current one & the one before that is rebuilt by flipping elements of it
+	//costs time proportional to rows that changed in the last step & elements flipped
+	void StepBack(const uint32_t * indices, const uint8_t * toggles, unsigned int numToggles);
+
+	//rows of planes. Row r of a face has GetRowWords(face) words, column c is bit c % 64 of word c / 64
+	unsigned int GetRowWords(unsigned int face) const;
+	const uint64_t * GetRow(unsigned int face, unsigned int row, const LifePlane plane) const;
+	void SetRow(unsigned int face, unsigned int row, const LifePlane plane, const uint64_t * words); //marks row as changed
+
+	unsigned int GetNumThreads(void) const;
+
+private:
+	//layout of one face in the planes. Every row has a zero guard word on each side and every face has a zero guard row above and below
+	typedef struct FaceLayout {
+		unsigned int m_rows;
+		unsigned int m_cols;
+		unsigned int m_words; //words holding data in each row
+		unsigned int m_stride; //words per row including padding & guards
+		unsigned int m_offset; //word of first guard row
+		unsigned int m_elementOffset; //flat index of first element
+		unsigned int m_maskOffset; //word of first column mask
+		unsigned int m_rowOffset; //first entry in row activity
+	} FaceLayout;
+
+	//band of rows in a face - unit of work for the thread pool
+	typedef struct RowTile {
+		unsigned int m_face;
+		unsigned int m_rowBegin;
+		unsigned int m_rowEnd;
+	} RowTile;
+
+	uint32_t GetBitPosition(unsigned int index) const; //bit holding element in a plane
+	const uint64_t * GetPlane(const LifePlane plane) const;
+	void MarkRowActive(unsigned int face, unsigned int row);
+	void ToggleElement(unsigned int buffer, unsigned int index, uint8_t toggle); //does not change row activity
+
+	bool IsTileActive(const RowTile & tile) const; //a row in the tile or next to it changed in last step
+
+	//bitsliced kernel - compiled for the rules used most, so matching neighbor counts is a few operations without branches
+	//other rules read birth & survival masks at run time (LIFE_RULE_RUNTIME)
+	template<uint16_t BIRTH, uint16_t SURVIVAL>
+	void StepRows(const RowTile & tile, bool fullSweep);
+	void StepSeams(unsigned int seamBegin, unsigned int seamEnd); //elements with neighbors outside their own face
+	void UpdateActivity(void);
+	void WriteRows(const RowTile & tile, unsigned int generationsAgo, ObjType * types) const;
+
+	const NeighborTable & m_neighborTable;
+
+	LifeRule m_rule;
+	void (LifeSimulation::*m_stepRows)(const RowTile & tile, bool fullSweep); //kernel for rule
+
+	FaceLayout m_faces[BoardSides::NUM_SIDES];
+	std::vector<uint64_t> m_columnMasks; //per face: stride words of valid column bits
+	std::vector<uint64_t> m_interiorMasks; //per face: stride words of columns not on the edge
+
+	//double buffered planes: [m_current] is the newest generation, [m_current ^ 1] the one before
+	std::vector<uint64_t> m_alive[2];
+	std::vector<uint64_t> m_owner[2];
+	unsigned int m_current;
+
+	//edge elements and neighbors as bit positions - compressed sparse row like neighbor table
+	std::vector<uint32_t> m_seamElements;
+	std::vector<uint32_t> m_seamOffsets;
+	std::vector<uint32_t> m_seamNeighbors;
+	std::vector<uint32_t> m_seamRows; //row activity entry of each edge element
+
+	//activity of every row of every face. Changed is set while stepping, quiet counts steps since the row last changed
+	//a row that was not stepped is the same in both generations, so skipping it leaves the planes valid
+	std::vector<uint8_t> m_rowChanged;
+	std::vector<uint8_t> m_rowQuiet;
+	unsigned int m_numActiveRows;
+
+	std::vector<RowTile> m_rowTiles;
+	std::vector<unsigned int> m_activeTiles; //row tiles stepped in current step
+	std::vector<unsigned int> m_seamTiles; //tile i is [m_seamTiles[i], m_seamTiles[i + 1]). Tiles never share a row
+
+	mutable ThreadPool m_threadPool; //used by const WriteTypes as well
+};
+
+#endif /* LIFESIMULATION_H */
@@ -10,12 +10,15 @@
 #include <GL/glew.h>    // Initialize with gl3wInit()
 
 #include "graphics.h"
+#include "framePacer.h"
 #include <iostream>
 
 class Menu {
 
 public:
-	Menu(const SDL_GLContext & gl_context, const glm::vec3 & eyeLoc, const glm::vec3 & eyeFocus, const glm::uvec2 & menuSize);
+	//menu is drawn over the main window, unless it is given a window of its own
+	Menu(SDL_Window * mainWindow, const SDL_GLContext & gl_context, const glm::vec3 & eyeLoc, const glm::vec3 & eyeFocus, const glm::uvec2 & menuSize,
+			bool ownWindow);
 	~Menu(void);
 
 	//Menu is not meant to be copied or moved
@@ -24,11 +27,15 @@ public:
 	Menu& operator=(const Menu &) = delete;
 	Menu& operator=(Menu&&) = delete;
 
-	bool Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEyeLoc, const glm::vec3 & currentEyeFocus); //returns true if menu has been undated
+	//overlay is drawn into the frame of the main window, so it has to be updated before the main window is swapped
+	bool Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEyeLoc, const glm::vec3 & currentEyeFocus, const FramePacer & pacer); //returns true if menu has been undated
 
-	void HandleEvent(SDL_Event event);
+	//returns true if the menu used the event. Overlay leaves events it does not want to the game - key & button releases always
+	bool HandleEvent(SDL_Event event);
+	void UseMouse(bool use); //overlay ignores the mouse while the camera has it
 
-	SDL_Window * GetWindow(void);
+	SDL_Window * GetWindow(void); //own window, or main window for the overlay
+	bool HasWindow(void) const;
 
 	glm::vec3 GetEyeLocation(void) const;
 	glm::vec3 GetEyeFocus(void) const;
@@ -38,6 +45,8 @@ private:
 	void UpdateMenuParams(void);
 
 	SDL_Window * m_window;
+	SDL_Window * m_mainWindow;
+	const bool m_ownWindow;
 
 	glm::vec3 m_eyeLoc;
 	glm::vec3 m_eyeFocus;
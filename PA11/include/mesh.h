@@ -0,0 +1,48 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include "graphics_headers.h"
+
+#include <vector>
+#include <map>
+#include <memory>
+
+//name quad meshes are shared under - see Mesh::GetQuad
+#define MESH_QUAD_NAME "<quad>"
+
+//vertices & indices of a mesh on the GPU, shared by every Object drawing it
+//meshes are loaded once per file & freed when the last Object using them is gone
+class Mesh {
+
+public:
+	Mesh(void) = delete;
+	~Mesh(void);
+
+	//Mesh is not meant to be copied or moved
+	Mesh(const Mesh &) = delete;
+	Mesh(Mesh &&) = delete;
+	Mesh& operator=(const Mesh &) = delete;
+	Mesh& operator=(Mesh&&) = delete;
+
+	//mesh of objFile - only loaded if no one is using it yet
+	static std::shared_ptr<Mesh> Get(const std::string & objFile);
+	//square the size of a face of a unit cube (-1 ... 1), given in the space of the face the instance is on:
+	//x & y along the face, z towards the inside of the board - the vertex shader turns it to face the inside of the board
+	static std::shared_ptr<Mesh> GetQuad(void);
+
+	void Render(unsigned int numInstances); //instance attributes have to be set up by caller
+
+private:
+	Mesh(const std::vector<Vertex> & vertices, const std::vector<unsigned int> & indices); //uploads mesh
+
+	static void LoadObjAssimp(const std::string & objFile, std::vector<Vertex> & vertices, std::vector<unsigned int> & indices);
+
+	//meshes in use by name - expired once their last user is gone. Only used from main thread
+	static std::map<std::string, std::weak_ptr<Mesh>> s_meshes;
+
+	unsigned int m_numIndices;
+	GLuint VB;
+	GLuint IB;
+};
+
+#endif /* MESH_H */
@@ -0,0 +1,58 @@
+#ifndef NEIGHBORTABLE_H
+#define NEIGHBORTABLE_H
+
+#include "gameInfo.h"
+
+#include <vector>
+#include <cstdint>
+
+//precomputed adjacency of every game element on the board (seams included)
+//faces have to cover the surface of a box, elements spaced out evenly - adjacency is found from their positions (see cubeBoard.h)
+//elements are addressed by a flat index: all of face 0 in row-major order, then face 1, ...
+//neighbors are stored in a compressed sparse row layout so no allocations are needed after construction
+class NeighborTable {
+
+public:
+	NeighborTable(void) = delete;
+	NeighborTable(const BoardInfo (&sides)[BoardSides::NUM_SIDES]);
+	~NeighborTable(void);
+
+	//NeighborTable is not meant to be copied or moved
+	NeighborTable(const NeighborTable &) = delete;
+	NeighborTable(NeighborTable &&) = delete;
+	NeighborTable& operator=(const NeighborTable &) = delete;
+	NeighborTable& operator=(NeighborTable&&) = delete;
+
+	unsigned int GetNumElements(void) const;
+	glm::uvec2 GetFaceSize(unsigned int face) const;
+	unsigned int GetFaceOffset(unsigned int face) const; //flat index of first element in face
+
+	//conversions between {face - BoardSides enumeration, row, column} and flat index
+	unsigned int GetIndex(const glm::uvec3 & element) const;
+	glm::uvec3 GetElement(unsigned int index) const;
+
+	//neighbors of element at flat index are in range [NeighborsBegin(index), NeighborsEnd(index))
+	inline const uint32_t * NeighborsBegin(unsigned int index) const {
+		return &m_neighbors[m_rowOffsets[index]];
+	}
+	inline const uint32_t * NeighborsEnd(unsigned int index) const {
+		return &m_neighbors[0] + m_rowOffsets[index + 1];
+	}
+	unsigned int GetNumNeighbors(unsigned int index) const;
+
+private:
+	bool IsValidElement(unsigned int face, unsigned int r, unsigned int c) const;
+
+	//only used while building the table
+	void FindLatticePoints(const BoardInfo (&sides)[BoardSides::NUM_SIDES], std::vector<glm::ivec3> & points) const;
+	void BuildNeighbors(const std::vector<glm::ivec3> & points);
+	void CheckFaces(void) const; //throws if an element away from the edges of its face has neighbors outside of it
+
+	glm::uvec2 m_faceSizes[BoardSides::NUM_SIDES];
+	uint32_t m_faceOffsets[BoardSides::NUM_SIDES + 1];
+
+	std::vector<uint32_t> m_rowOffsets; //size = number of elements + 1
+	std::vector<uint32_t> m_neighbors; //flat indices of neighbors
+};
+
+#endif /* NEIGHBORTABLE_H */
@@ -1,7 +1,7 @@
 #ifndef OBJECT_H
 #define OBJECT_H
 
-#include "graphics_headers.h"
+#include "mesh.h"
 
 #include <vector>
 
@@ -11,6 +11,8 @@ public:
 	Object(const std::string & objFile, const glm::uvec2 & size, const glm::vec3 & changeRow, const glm::vec3 & changeCol,
 			const glm::vec3 & traslation = glm::vec3(0, 0, 0), const glm::vec3 & rotation = glm::vec3(0, 0, 0),
 			const glm::vec3 & scale = glm::vec3(1, 1, 1));
+	//one quad per instance instead of a mesh from a file - see Mesh::GetQuad
+	Object(const glm::uvec2 & size, const glm::vec3 & changeRow, const glm::vec3 & changeCol, const glm::vec3 & traslation = glm::vec3(0, 0, 0));
 	~Object(void);
 
 	//Object is not meant to be copied or moved
@@ -20,9 +22,9 @@ public:
 	Object& operator=(Object&&) = delete;
 
 	void Update(void);
-	void Render(void);
+	void Render(unsigned int numInstances); //instance attributes have to be set up by caller
 
-	void BindTextures(void);
+	void BindTextures(void); //binds texture array to texture unit 0
 
 	glm::mat4 GetModel(void);
 
@@ -37,12 +39,7 @@ public:
 
 	glm::vec3 GetNormal(void) const;
 
-	ObjType GetType(unsigned int r, unsigned int c) const;
-	const std::vector<ObjType>& GetTypesList(void) const;
-	void SetType(unsigned int r, unsigned int c, const ObjType type = ObjType::DEAD);
-
 	const std::vector<glm::vec3>& GetInstancePositions(void) const;
-	glm::uvec2 GetCubeByPosition(const glm::vec3 & position) const; //use to find cube at position - return {r,c}
 
 	glm::uvec2 GetSize(void) const;
 	bool IsValidElement(const glm::uvec2 & pos) const; //checks if given element is valid in regards to bounds of instance sizes
@@ -50,10 +47,10 @@ public:
 	glm::vec3 GetChangeRow(void) const;
 	glm::vec3 GetChangeCol(void) const;
 
-	void LoadTexture(const std::string & textureFile, const ObjType type = ObjType::DEAD);
+	void LoadTextures(const std::string (&textureFiles)[ObjType::NUM_TYPES]); //one texture for every type
 
 private:
-	void LoadObjAssimp(const std::string & objFile);
+	void FindInstancePositions(void);
 
 	glm::mat4 m_model;
 
@@ -66,15 +63,11 @@ private:
 	const glm::uvec2 m_numInstances; //{x = row, y = col}
 	glm::vec3 m_changeRow;
 	glm::vec3 m_changeCol;
-	std::vector<ObjType> m_types;
 	std::vector<glm::vec3> m_instancePositions;
 
-	std::vector<Vertex> m_vertices;
-	std::vector<unsigned int> m_indices;
-	GLuint VB;
-	GLuint IB;
+	std::shared_ptr<Mesh> m_mesh; //shared with every Object using the same mesh
 
-	GLuint m_textures[ObjType::NUM_TYPES]; //vector of texture locations on GPU {follow enumaration layout}
+	GLuint m_textures; //texture array on GPU - one layer for every type {follow enumaration layout}
 };
 
 #endif /* OBJECT_H */
@@ -0,0 +1,56 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//persistent pool of worker threads for data parallel loops
+//tasks of a loop are split evenly between the threads, a thread that runs out of tasks steals from the others
+class ThreadPool {
+
+public:
+	ThreadPool(void) = delete;
+	ThreadPool(unsigned int numThreads); //0 = one thread per hardware thread
+	~ThreadPool(void);
+
+	//ThreadPool is not meant to be copied or moved
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool(ThreadPool &&) = delete;
+	ThreadPool& operator=(const ThreadPool &) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+
+	unsigned int GetNumThreads(void) const; //includes calling thread
+
+	//runs task(0) ... task(numTasks - 1) and returns once all are done. Calling thread works on tasks as well
+	void ParallelFor(unsigned int numTasks, const std::function<void(unsigned int)> & task);
+	//same, but task(i, thread) also gets the thread running it in [0, GetNumThreads()) - for per thread scratch space
+	void ParallelFor(unsigned int numTasks, const std::function<void(unsigned int, unsigned int)> & task);
+
+private:
+	//range of tasks owned by a thread - other threads steal from the same counter
+	typedef struct alignas(64) TaskQueue {
+		std::atomic<unsigned int> m_next;
+		unsigned int m_end;
+	} TaskQueue;
+
+	void WorkerLoop(unsigned int queue);
+	void RunTasks(unsigned int queue); //runs own tasks, then steals until no tasks are left
+
+	std::vector<std::thread> m_workers;
+	std::unique_ptr<TaskQueue[]> m_queues; //[0] belongs to calling thread, [i + 1] to worker i
+
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition;
+	std::condition_variable m_doneCondition;
+	const std::function<void(unsigned int, unsigned int)> * m_task;
+	unsigned int m_loop; //incremented for every loop so workers know when to start
+	unsigned int m_busyWorkers;
+	bool m_shutdown;
+};
+
+#endif /* THREADPOOL_H */
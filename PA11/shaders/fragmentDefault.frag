@@ -1,15 +1,14 @@
 #version 330
 
-flat in int obj_row, obj_col;
+flat in int obj_type;
 
 smooth in vec3 v_posWorld, v_normalWorld;
-smooth in vec2 texture;
+smooth in vec2 texCoord;
 
 out vec4 frag_color;
 
-uniform sampler2D samplers[11];
-uniform int sampleType[500];
-uniform int numPerRow;
+//texture of every type - one layer per type
+uniform sampler2DArray stateTextures;
 
 uniform vec3 ambientP, diffuseP, specularP;
 uniform float shininess;
@@ -21,32 +20,8 @@ uniform vec3 eyePos;
 vec3 addLight(vec3 baseColor, vec3 lightPosition);
 
 void main(void){
-  vec4 baseColor;
-
-  int currentSample = sampleType[obj_row * numPerRow + obj_col]; 
-  
-  if(currentSample== 1)
-    baseColor = texture2D(samplers[1], texture);
-  else if(currentSample == 2)
-    baseColor = texture2D(samplers[2], texture);
-  else if(currentSample == 3)
-    baseColor = texture2D(samplers[3], texture);
-  else if(currentSample == 4)
-    baseColor = texture2D(samplers[4], texture);
-  else if(currentSample == 5)
-    baseColor = texture2D(samplers[5], texture);
-  else if(currentSample == 6)
-    baseColor = texture2D(samplers[6], texture);
-  else if(currentSample == 7)
-    baseColor = texture2D(samplers[7], texture);
-  else if(currentSample == 8)
-    baseColor = texture2D(samplers[8], texture);
-  else if(currentSample == 9)
-    baseColor = texture2D(samplers[9], texture);
-  else if(currentSample == 10)
-    baseColor = texture2D(samplers[10], texture);
-  else
-    baseColor = texture2D(samplers[0], texture);
+  //layer of texture array = type of element
+  vec4 baseColor = texture(stateTextures, vec3(texCoord, float(obj_type)));
 
   //add contribution of light
   baseColor = vec4(addLight(baseColor.rgb, lightPos), baseColor.a);
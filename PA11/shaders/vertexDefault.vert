@@ -4,25 +4,40 @@ layout (location = 0) in vec3 v_pos;
 layout (location = 1) in vec3 v_normal;
 layout (location = 2) in vec2 v_texture;
 
-flat out int obj_row, obj_col;
+//per instance - one instance for every element on the board
+layout (location = 3) in vec3 i_offset;
+layout (location = 4) in vec3 i_faceNormal;
+layout (location = 5) in uint i_element;
+
+flat out int obj_type;
 
 smooth out vec3 v_posWorld, v_normalWorld;
-smooth out vec2 texture;
+smooth out vec2 texCoord;
 
 uniform mat4 model, view, projection;
 
-uniform vec3 changeRow, changeCol;
-uniform int numPerRow;
+//type of every element on the board - one byte per element
+uniform usamplerBuffer types;
+
+//mesh is a quad given in the space of the face (x & y along it, z along i_faceNormal) instead of a mesh in world space
+uniform bool faceQuads;
 
 void main(void){
-  obj_row = gl_InstanceID / numPerRow;
-  obj_col = gl_InstanceID % numPerRow;
-  vec3 v_posInstance = v_pos + (changeRow * obj_row) + (changeCol * obj_col);
+  obj_type = int(texelFetch(types, int(i_element)).r);
+  vec3 v_posInstance = v_pos + i_offset;
+  vec3 v_normalInstance = v_normal;
+
+  if(faceQuads){
+    vec3 tangent = normalize(cross(i_faceNormal, (abs(i_faceNormal.y) < 0.9) ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0)));
+    mat3 face = mat3(tangent, cross(i_faceNormal, tangent), i_faceNormal);
+    v_posInstance = face * v_pos + i_offset;
+    v_normalInstance = face * v_normal;
+  }
   
   v_posWorld = (model * vec4(v_posInstance, 1.0)).xyz;
-  v_normalWorld = mat3(transpose(inverse(model))) * v_normal;  
+  v_normalWorld = mat3(transpose(inverse(model))) * v_normalInstance;  
   
-  texture = v_texture;
+  texCoord = v_texture;
   
   gl_Position = projection * view * vec4(v_posWorld, 1.0);
 }
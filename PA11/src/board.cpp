@@ -1,38 +1,90 @@
 #include "board.h"
+#include "trace.h"
+
+#include <cstring>
+#include <algorithm>
 
 Board::Board(const GameInfo & game) :
 		m_shaderCurrent(nullptr), m_ambientLevel(game.m_ambientLevel), m_diffuseLevel(game.m_object.m_diffuseLevel), m_specularLevel(
-				game.m_object.m_specularLevel), m_shininessConst(game.m_object.m_shininess), m_spotlightLoc(0.0, 0.0, 0.0), m_broadphase(nullptr), m_collisionConfiguration(
-				nullptr), m_dispatcher(nullptr), m_solver(nullptr), m_dynamicsWorld(nullptr) {
+				game.m_object.m_specularLevel), m_shininessConst(game.m_object.m_shininess), m_faceQuadsConst(game.m_object.m_faceQuads), m_spotlightLoc(0.0, 0.0, 0.0), m_neighborTable(game.m_sides), m_publishedTypes(0), m_frontTypes(
+				0), m_simulation(m_neighborTable, game.m_simulationThreads), m_history(m_neighborTable, size_t(game.m_historySize) << 20), m_ai(
+				m_neighborTable, game.m_simulationThreads, game.m_aiLookahead, game.m_aiTimeBudget), m_log(nullptr), m_replay(nullptr) {
+	TRACE_SCOPE("Load board");
+
+	for (unsigned int i = 0; i < 2; ++i) {
+		m_types[i].resize(m_neighborTable.GetNumElements(), DEAD);
+		std::fill(m_typeCounts[i], m_typeCounts[i] + ObjType::NUM_TYPES, 0);
+		m_typeCounts[i][DEAD] = m_neighborTable.GetNumElements();
+	}
+	m_simulation.SetRule(game.m_rule);
+	m_populationHistory.push_back(GetPopulation(0));
+	m_history.Clear(m_simulation, 0);
+
+	//load types into buffer texture
+	glGenBuffers(1, &m_typeBuffer);
+	glBindBuffer(GL_TEXTURE_BUFFER, m_typeBuffer);
+	glBufferData(GL_TEXTURE_BUFFER, m_types[0].size() * sizeof(ObjType), &m_types[0][0], GL_DYNAMIC_DRAW);
+
+	glGenTextures(1, &m_typeTexture);
+	glActiveTexture(GL_TEXTURE0 + TYPE_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_BUFFER, m_typeTexture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_R8UI, m_typeBuffer);
+
+	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i) {
+		if (m_faceQuadsConst)
+			m_sides[i] = new Object(game.m_sides[i].m_size, game.m_sides[i].m_changeRow, game.m_sides[i].m_changeCol, game.m_sides[i].m_startingLoc);
+		else
+			m_sides[i] = new Object(game.m_object.m_objFile, game.m_sides[i].m_size, game.m_sides[i].m_changeRow, game.m_sides[i].m_changeCol,
+					game.m_sides[i].m_startingLoc);
+	}
 
+	//center of the board - normals of faces are turned to point at it
+	glm::vec3 low(m_sides[0]->GetTranslation()), high(low);
 	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i)
-		m_sides[i] = new Object(game.m_object.m_objFile, game.m_sides[i].m_size, game.m_sides[i].m_changeRow, game.m_sides[i].m_changeCol,
-				game.m_sides[i].m_startingLoc);
+		for (const glm::vec3 & position : m_sides[i]->GetInstancePositions()) {
+			low = glm::min(low, position);
+			high = glm::max(high, position);
+		}
+	const glm::vec3 center = (low + high) * 0.5f;
+
+	//per instance attributes of every element in flat index order
+	std::vector<InstanceData> instances;
+	instances.reserve(m_neighborTable.GetNumElements());
+	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i) {
+		glm::vec3 normal = m_sides[i]->GetNormal();
+		if (glm::dot(normal, center - m_sides[i]->GetTranslation()) < 0.f)
+			normal = -normal;
+
+		for (const glm::vec3 & position : m_sides[i]->GetInstancePositions())
+			instances.emplace_back(position, normal, instances.size());
+	}
+
+	glGenBuffers(1, &m_instanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceData) * instances.size(), &instances[0], GL_STATIC_DRAW);
 
 	//load textures
-	for (int i = 0; i < ObjType::NUM_TYPES; ++i)
-		m_sides[0]->LoadTexture(game.m_textures[i], static_cast<ObjType>(i));
+	m_sides[0]->LoadTextures(game.m_textures);
 	m_sides[0]->BindTextures();
-
-	InitializeBullet(); //start bullet for raycasting
 }
 
 Board::~Board(void) {
+	delete m_log;
+	delete m_replay;
+
 	for (std::pair<std::string, Shader *> temp : m_shaders)
 		delete temp.second;
 
 	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i)
 		delete m_sides[i];
 
-	//clean up bullet world
-	delete m_dynamicsWorld;
-	delete m_solver;
-	delete m_dispatcher;
-	delete m_collisionConfiguration;
-	delete m_broadphase;
+	glDeleteTextures(1, &m_typeTexture);
+	glDeleteBuffers(1, &m_typeBuffer);
+	glDeleteBuffers(1, &m_instanceBuffer);
 }
 
 void Board::AddShaderSet(const std::string & setName, const std::string & vertexShaderSrc, const std::string & fragmentShaderSrc) {
+	TRACE_SCOPE("Load shaders");
 	m_shaders.push_back(std::pair<std::string, Shader *>(setName, new Shader())); //Set up the shader
 	m_shaders.back().second->AddShader(GL_VERTEX_SHADER, vertexShaderSrc); //Add the vertex shader
 	m_shaders.back().second->AddShader(GL_FRAGMENT_SHADER, fragmentShaderSrc); //Add the fragment shader
@@ -72,19 +124,20 @@ void Board::UseShaderSet(const std::string & setName) {
 	bindUniform(m_shininess, "shininess");
 
 	//find instancing uniforms
-	bindUniform(m_instanceChangeRow, "changeRow");
-	bindUniform(m_instanceChangeCol, "changeCol");
-	bindUniform(m_instanceNumPerRow, "numPerRow");
-	bindUniform(m_samplers, "samplers");
-	bindUniform(m_sampleTypes, "sampleType");
+	bindUniform(m_stateSampler, "stateTextures");
+	bindUniform(m_typeSampler, "types");
+	bindUniform(m_faceQuads, "faceQuads");
 
 	m_shaderCurrent->Enable();
 
-	const int samplerNums[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
-	glUniform1iv(m_samplers, 11, samplerNums);
+	glUniform1i(m_stateSampler, 0);
+	glUniform1i(m_typeSampler, TYPE_TEXTURE_UNIT);
+	glUniform1i(m_faceQuads, m_faceQuadsConst);
 }
 
 void Board::Update(void) {
+	PickUpGeneration();
+
 	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i)
 		m_sides[i]->Update();
 }
@@ -93,13 +146,59 @@ void Board::Render(void) {
 	if (!m_shaderCurrent) //Ensure shader is enabled
 		throw std::string("No shader has been enabled!");
 
-	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i) {
-		UpdateInstanceBindings (m_sides[i]);
-		glUniformMatrix4fv(m_modelMatrix, 1, GL_FALSE, glm::value_ptr(m_sides[i]->GetModel()));
-		m_sides[i]->Render();
+	//instances are placed in world space
+	glUniformMatrix4fv(m_modelMatrix, 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0)));
+
+	glEnableVertexAttribArray(3);
+	glEnableVertexAttribArray(4);
+	glEnableVertexAttribArray(5);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*) offsetof(InstanceData, m_offset));
+	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*) offsetof(InstanceData, m_faceNormal));
+	glVertexAttribIPointer(5, 1, GL_UNSIGNED_INT, sizeof(InstanceData), (void*) offsetof(InstanceData, m_element));
+	glVertexAttribDivisor(3, 1);
+	glVertexAttribDivisor(4, 1);
+	glVertexAttribDivisor(5, 1);
+
+	//quads only face the inside of the board - their backs never have to be drawn
+	if (m_faceQuadsConst)
+		glEnable(GL_CULL_FACE);
+	m_sides[0]->Render(m_neighborTable.GetNumElements());
+	if (m_faceQuadsConst)
+		glDisable(GL_CULL_FACE);
+
+	glDisableVertexAttribArray(3);
+	glDisableVertexAttribArray(4);
+	glDisableVertexAttribArray(5);
+}
+
+//swap in newest generation - lock free so rendering never waits on the generation thread
+//every generation is picked up, so only the elements that changed from the one before have to be uploaded
+void Board::PickUpGeneration(void) {
+	unsigned int published = m_publishedTypes.load(std::memory_order_acquire);
+	if (published != m_frontTypes.load(std::memory_order_relaxed)) {
+		TRACE_SCOPE("Upload types");
+		glBindBuffer(GL_TEXTURE_BUFFER, m_typeBuffer);
+		for (const glm::uvec2 & range : m_changedTypes[published])
+			glBufferSubData(GL_TEXTURE_BUFFER, range.x * sizeof(ObjType), (range.y - range.x) * sizeof(ObjType), &m_types[published][range.x]);
+
+		{
+			std::lock_guard<std::mutex> lock(m_frontMutex); //a generation thread about to wait cannot miss the change
+			m_frontTypes.store(published, std::memory_order_release);
+		}
+		m_frontCondition.notify_all();
+
+		m_populationHistory.push_back(GetPopulation(published));
+		TRACE_COUNTER("Player 1 cells", m_populationHistory.back().x);
+		TRACE_COUNTER("Player 2 cells", m_populationHistory.back().y);
 	}
 }
 
+bool Board::HasNewGeneration(void) const {
+	return m_publishedTypes.load(std::memory_order_acquire) != m_frontTypes.load(std::memory_order_acquire);
+}
+
 void Board::ChangeAmbientLight(const glm::vec3 & change) {
 	m_ambientLevel += change;
 	EnforceBounds (m_ambientLevel);
@@ -152,47 +251,28 @@ void Board::UpdateLightBindings(void) {
 	glUniform1f(m_shininess, m_shininessConst);
 }
 
-void Board::UpdateInstanceBindings(Object * obj) {
-	glm::vec3 changeRow = obj->GetChangeRow();
-	glm::vec3 changeCol = obj->GetChangeCol();
-	const std::vector<ObjType> types = obj->GetTypesList();
-
-	glUniform1iv(m_sampleTypes, types.size(), reinterpret_cast<const int*>(&types[0]));
-	glUniform3f(m_instanceChangeRow, changeRow.x, changeRow.y, changeRow.z);
-	glUniform3f(m_instanceChangeCol, changeCol.x, changeCol.y, changeCol.z);
-	glUniform1i(m_instanceNumPerRow, (int) obj->GetSize().y);
-}
-
-const btDiscreteDynamicsWorld * Board::GetBulletWorld(void) const {
-	return m_dynamicsWorld;
-}
-
-//finds specific element at position. returns {face - BoardSides enumeration, row, column}
-glm::uvec3 Board::GetGameElementByPosition(const glm::vec3 & position) const {
-#ifdef DEBUG
-	printf("\nSearching board for postion: |%s|\n", glm::to_string(position).c_str());
-#endif
+//intersects ray with the elements of every face. returns {face - BoardSides enumeration, row, column} of closest one
+glm::uvec3 Board::GetGameElementByRay(const glm::vec3 & start, const glm::vec3 & direction) const {
+	float closestDistance = PICK_DISTANCE, distance;
+	glm::uvec3 closestElement;
+	bool found = false;
+	glm::uvec2 element;
 
 	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i) {
-		glm::vec3 testVector = (position - m_sides[i]->GetTranslation()); //vector between point and main cube and board - should be orthogonal to normal if in plane
+		if (RaycastFace(i, start, direction, distance, element) && distance < closestDistance) {
+			closestDistance = distance;
+			closestElement = glm::uvec3(i, element);
+			found = true;
+		}
+	}
+
+	if (!found)
+		throw std::string("No element hit by ray from |" + glm::to_string(start) + "| in direction |" + glm::to_string(direction) + "|");
 
 #ifdef DEBUG
-		printf("%i\n", i);
-		printf("Normal of current board: |%s|\n", glm::to_string(m_sides[i]->GetNormal()).c_str());
-		printf("Vector to test against normal: |%s|\n", glm::to_string(testVector).c_str());
-#endif
-		if (glm::length2(testVector) < 0.001 || glm::dot(testVector, m_sides[i]->GetNormal()) == 0) { //p lies on a plane defined by m_side[i]
-			try { //search for position
-				glm::uvec3 elementPos(i, m_sides[i]->GetCubeByPosition(position));
-#ifdef DEBUG
-				printf("Element found: |%s|\n", glm::to_string(elementPos).c_str());
+	printf("\nElement hit: |%s|\n", glm::to_string(closestElement).c_str());
 #endif
-				return elementPos;
-			} catch (const std::string &) { //not found in this side. Keep searching cause it could still be in same plane but be part of another, perpendicular side
-			}
-		}
-	}
-	throw std::string("Position |" + glm::to_string(position) + "| not found!");
+	return closestElement;
 }
 
 //finds position of all the neighbors. element = {face - BoardSides enumeration, row, column}
@@ -202,321 +282,330 @@ std::vector<glm::uvec3> Board::GetGameElementNeighbors(const glm::uvec3 & elemen
 #endif
 	std::vector < glm::uvec3 > neighbors;
 
-	FindElementNeighborsInFace(neighbors, element); //get neighbors in same face
+	//look up in precomputed table
+	unsigned int index = m_neighborTable.GetIndex(element);
+	for (const uint32_t * n = m_neighborTable.NeighborsBegin(index); n != m_neighborTable.NeighborsEnd(index); ++n)
+		neighbors.push_back(m_neighborTable.GetElement(*n));
 
+	return neighbors;
+}
+
+//get current status of game element. element = {face - BoardSides enumeration, row, column}
+ObjType Board::GetGameElementType(const glm::uvec3 & element) const {
 #ifdef DEBUG
-	printf("Got neighbors on the same face. Checking if element has neighbors on another face\n");
+	printf("\nGetting element type for element: |%s|\n", glm::to_string(element).c_str());
 #endif
+	return GetGameElementType(m_neighborTable.GetIndex(element));
+}
 
-	//for getting neighbors in different faces
-	//Note: some of this had to be hard coded. So changing the configuration file/board dimensions may cause errors here
-	glm::uvec2 faceSize = m_sides[element.x]->GetSize();
-	BoardSides tempSide;
-
-	//helper function to add neighbor if possible
-	auto addNeighbor = [this, &tempSide, &neighbors](unsigned int r, unsigned int c)->void {
-		if (m_sides[tempSide]->IsValidElement(glm::uvec2(r, c))) {
-			neighbors.emplace_back(tempSide, r, c);
-		}
-	};
-
-	if (element.y == 0) { //element is in first row
-
-		switch ((BoardSides) element.x) {
-
-		case BoardSides::FLOOR: //0
-			tempSide = BoardSides::NORTH;
-
-			addNeighbor(0, element.z + 1);
-			addNeighbor(0, element.z);
-			addNeighbor(0, element.z + 2);
-			break;
+//set currents status of game element. element = {face - BoardSides enumeration, row, column}
+void Board::SetGameElementType(const glm::uvec3 & element, const ObjType type) {
+#ifdef DEBUG
+	printf("\nSetting element |%s| to type: %i\n", glm::to_string(element).c_str(), type);
+#endif
+	SetGameElementType(m_neighborTable.GetIndex(element), type);
+}
 
-		case BoardSides::ROOF: //1
-			tempSide = BoardSides::NORTH;
+glm::uvec3 Board::GetNextGameElement(const glm::uvec3 & currentElement) const {
+	if (m_sides[currentElement.x]->IsValidElement(glm::uvec2(currentElement.y, currentElement.z + 1))) //try next element in row
+		return glm::uvec3(currentElement.x, currentElement.y, currentElement.z + 1);
+	else if (m_sides[currentElement.x]->IsValidElement(glm::uvec2(currentElement.y + 1, 0))) //try next row
+		return glm::uvec3(currentElement.x, currentElement.y + 1, 0);
+	else if (currentElement.x + 1 < BoardSides::NUM_SIDES) //try next face
+		return glm::uvec3(currentElement.x + 1, 0, 0);
+	else
+		return glm::uvec3(0, 0, 0); //done go back to first element
+}
 
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z - 1);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z + 1);
-			break;
+const NeighborTable & Board::GetNeighborTable(void) const {
+	return m_neighborTable;
+}
 
-		case BoardSides::NORTH: //2
-			tempSide = BoardSides::FLOOR;
+unsigned int Board::GetNumGameElements(void) const {
+	return m_neighborTable.GetNumElements();
+}
 
-			addNeighbor(0, element.z - 1);
-			addNeighbor(0, element.z - 2);
-			addNeighbor(0, element.z);
-			break;
+//game elements are read and changed on newest generation. Changes show up once the renderer picks it up
+ObjType Board::GetGameElementType(unsigned int index) const {
+	return m_types[m_publishedTypes.load(std::memory_order_acquire)][index];
+}
 
-		case BoardSides::SOUTH: //3
-			tempSide = BoardSides::FLOOR;
+void Board::SetGameElementType(unsigned int index, const ObjType type) {
+	PickUpGeneration(); //rendered generation has to be newest one so change can be uploaded right away
+
+	unsigned int published = m_publishedTypes.load(std::memory_order_acquire);
+	ObjType & current = m_types[published][index];
+	if (current != type) {
+		--m_typeCounts[published][current];
+		++m_typeCounts[published][type];
+		current = type;
+		glBindBuffer(GL_TEXTURE_BUFFER, m_typeBuffer);
+		glBufferSubData(GL_TEXTURE_BUFFER, index * sizeof(ObjType), sizeof(ObjType), &current);
+	}
+	EditElement(index, type);
+}
 
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z - 1);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z - 2);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z);
-			break;
+//edits by hand & replayed ones have to reach everything that follows the generations, or rewinding & cycle detection go wrong
+void Board::EditElement(unsigned int index, const ObjType type) {
+	uint8_t state = m_simulation.GetState(index);
+	m_simulation.SetElement(index, type);
+	m_history.AddEdit(index, state ^ m_simulation.GetState(index));
+	m_cycleDetector.AddEdit(index, state, m_simulation.GetState(index));
 
-		case BoardSides::EAST: //4
-			tempSide = BoardSides::FLOOR;
+	if (m_log)
+		m_log->AddEdit(index, m_simulation.GetState(index));
+}
 
-			addNeighbor(element.z - 1, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.z - 2, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.z, m_sides[tempSide]->GetSize().y - 1);
-			break;
+bool Board::StepGeneration(void) {
+	TRACE_SCOPE("Step generation");
+	unsigned int front = m_publishedTypes.load(std::memory_order_acquire);
 
-		case BoardSides::WEST: //5
-			tempSide = BoardSides::FLOOR;
+	//back buffer may still be drawn until renderer picks up the last generation
+	{
+		TRACE_SCOPE("Wait for renderer");
+		std::unique_lock<std::mutex> lock(m_frontMutex);
+		m_frontCondition.wait(lock, [this, front] {return m_frontTypes.load(std::memory_order_acquire) == front;});
+	}
 
-			addNeighbor(element.z, 0);
-			addNeighbor(element.z - 1, 0);
-			addNeighbor(element.z + 1, 0);
-			break;
+	if (!m_replay) {
+		TRACE_SCOPE("Simulate");
+		m_simulation.Step();
+	} else {
+		TRACE_SCOPE("Replay");
+		try {
+			if (!m_replay->NextEdits(m_editIndices, m_editStates)) {
+				printf("\nReplay is done at generation %llu!\n", (unsigned long long) m_replay->GetGeneration());
+				StopReplay();
+				return false;
+			}
 
-		default:
-			throw std::string("Invalid element face number:" + glm::to_string(element));
+			//edits & generation were checked by NextEdits, so nothing is left half done from here on
+			for (unsigned int i = 0; i < m_editIndices.size(); ++i) {
+				if (!(m_editStates[i] & LIFE_STATE_ALIVE))
+					EditElement(m_editIndices[i], DEAD);
+				else
+					EditElement(m_editIndices[i], (m_editStates[i] & LIFE_STATE_PLAYER2) ? P2_ALIVE : P1_ALIVE);
+			}
+			m_replay->NextGeneration(m_simulation);
+		} catch (std::string & err) {
+			//a broken file should not end the game - stop using it & keep simulating
+			printf("\n%s\n", err.c_str());
+			StopReplay();
+			return false;
 		}
+	}
 
-	} else if (element.y == faceSize.x - 1) { //element is in last row
-
-		switch ((BoardSides) element.x) {
-
-		case BoardSides::FLOOR: //0
-			tempSide = BoardSides::SOUTH;
-
-			addNeighbor(0, element.z + 1);
-			addNeighbor(0, element.z);
-			addNeighbor(0, element.z + 2);
-			break;
-
-		case BoardSides::ROOF: //1
-			tempSide = BoardSides::SOUTH;
-
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z - 1);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z + 1);
-			break;
-
-		case BoardSides::NORTH: //2
-			tempSide = BoardSides::ROOF;
-
-			addNeighbor(0, element.z);
-			addNeighbor(0, element.z - 1);
-			addNeighbor(0, element.z + 1);
-			break;
-
-		case BoardSides::SOUTH: //3
-			tempSide = BoardSides::ROOF;
-
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z - 1);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.z + 1);
-			break;
-
-		case BoardSides::EAST: //4
-			tempSide = BoardSides::ROOF;
-
-			addNeighbor(element.z, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.z - 1, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.z + 1, m_sides[tempSide]->GetSize().y - 1);
-			break;
-
-		case BoardSides::WEST: //5
-			tempSide = BoardSides::ROOF;
-
-			addNeighbor(element.z + 1, 0);
-			addNeighbor(element.z, 0);
-			addNeighbor(element.z + 2, 0);
-			break;
-
-		default:
-			throw std::string("Invalid element face number:" + glm::to_string(element));
+	TRACE_SCOPE("Record changes");
+	m_simulation.GetChanges(m_changeIndices, m_changeStates);
+	m_cycleDetector.AddGeneration(m_simulation, m_changeIndices, m_changeStates);
+	m_history.AddGeneration(m_simulation, m_changeIndices, m_changeStates);
+	if (m_log) {
+		try {
+			m_log->AddGeneration(m_changeIndices, m_changeStates);
+		} catch (std::string & err) {
+			printf("\n%s\n", err.c_str());
+			StopRecording();
 		}
-
 	}
 
-	if (element.z == 0) { //element is in first column
-
-		switch ((BoardSides) element.x) {
-
-		case BoardSides::FLOOR: //0
-			tempSide = BoardSides::WEST;
-
-			addNeighbor(element.z, element.y);
-			addNeighbor(element.z, element.y - 1);
-			addNeighbor(element.z, element.y + 1);
-			break;
-
-		case BoardSides::ROOF: //1
-			tempSide = BoardSides::WEST;
-
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.y - 1);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.y - 2);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.y);
-			break;
+	PublishGeneration();
+	return true;
+}
 
-		case BoardSides::NORTH: //2
-			tempSide = BoardSides::WEST;
+//writes types of newest generation into back buffer & swaps buffers
+void Board::PublishGeneration(void) {
+	unsigned int front = m_publishedTypes.load(std::memory_order_acquire);
+	m_simulation.WriteTypes(&m_types[front ^ 1][0], 2); //back buffer holds generation from 2 steps ago
+	FindChangedTypes(front, front ^ 1);
 
-			addNeighbor(element.y, 0);
-			addNeighbor(element.y - 1, 0);
-			addNeighbor(element.y + 1, 0);
-			break;
+	m_publishedTypes.store(front ^ 1, std::memory_order_release); //swap buffers
+}
 
-		case BoardSides::SOUTH: //3
-			tempSide = BoardSides::WEST;
+//replay & recording follow the generations going forward, so both are stopped
+uint64_t Board::RewindTo(uint64_t generation) {
+	StopReplay();
+	StopRecording();
+	PickUpGeneration(); //back buffer is written right away
 
-			addNeighbor(element.y, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.y - 1, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.y + 1, m_sides[tempSide]->GetSize().y - 1);
-			break;
+	uint64_t current = m_history.GetGeneration();
+	m_history.RewindTo(m_simulation, generation);
+	if (!m_cycleDetector.Rewind(current - m_history.GetGeneration()))
+		m_cycleDetector.Reset(m_simulation, m_neighborTable.GetNumElements());
 
-		case BoardSides::EAST: //4
-			tempSide = BoardSides::NORTH;
+	//population history goes back as well & picking up adds the generation rewound to
+	size_t dropped = std::min<size_t>(m_populationHistory.size(), current - m_history.GetGeneration() + 1);
+	m_populationHistory.resize(m_populationHistory.size() - dropped);
+	PublishGeneration();
+	PickUpGeneration();
 
-			addNeighbor(element.y, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.y - 1, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.y + 1, m_sides[tempSide]->GetSize().y - 1);
-			break;
+	return m_history.GetGeneration();
+}
 
-		case BoardSides::WEST: //5
-			tempSide = BoardSides::NORTH;
+uint64_t Board::GetOldestGeneration(void) const {
+	return m_history.GetOldestGeneration();
+}
 
-			addNeighbor(element.y, 0);
-			addNeighbor(element.y - 1, 0);
-			addNeighbor(element.y + 1, 0);
-			break;
+unsigned int Board::GetPeriod(void) const {
+	return m_cycleDetector.GetPeriod();
+}
 
-		default:
-			throw std::string("Invalid element face number:" + glm::to_string(element));
-		}
+void Board::ClearHistory(uint64_t generation) {
+	m_history.Clear(m_simulation, generation);
+}
 
-	} else if (element.z == faceSize.y - 1) { //element is in last column
+AIMove Board::FindAIMove(bool player2) {
+	return m_ai.FindMove(m_simulation, &m_types[m_publishedTypes.load(std::memory_order_acquire)][0], player2);
+}
 
-		switch ((BoardSides) element.x) {
+unsigned int Board::GetAIMovesScored(void) const {
+	return m_ai.GetMovesScored();
+}
 
-		case BoardSides::FLOOR: //0
-			tempSide = BoardSides::EAST;
+void Board::SaveSnapshot(const std::string & fileName, uint64_t generation) const {
+	WriteSnapshot(fileName, m_simulation, m_neighborTable, generation);
+}
 
-			addNeighbor(0, element.y + 1);
-			addNeighbor(0, element.y);
-			addNeighbor(0, element.y + 2);
-			break;
+//while recording, loading is logged as an edit of every element that changed
+uint64_t Board::LoadSnapshot(const std::string & fileName) {
+	std::vector<uint8_t> states;
+	if (m_log) {
+		states.resize(m_neighborTable.GetNumElements());
+		for (unsigned int i = 0; i < states.size(); ++i)
+			states[i] = m_simulation.GetState(i);
+	}
 
-		case BoardSides::ROOF: //1
-			tempSide = BoardSides::EAST;
+	uint64_t generation = ReadSnapshot(fileName, m_simulation, m_neighborTable);
+	StopReplay();
+	RefreshTypes();
+	m_history.Clear(m_simulation, generation);
+	m_cycleDetector.Reset(m_simulation, m_neighborTable.GetNumElements());
 
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.y);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.y - 1);
-			addNeighbor(m_sides[tempSide]->GetSize().x - 1, element.y + 1);
-			break;
+	for (unsigned int i = 0; i < states.size(); ++i)
+		if (m_simulation.GetState(i) != states[i])
+			m_log->AddEdit(i, m_simulation.GetState(i));
 
-		case BoardSides::NORTH: //2
-			tempSide = BoardSides::EAST;
+	return generation;
+}
 
-			addNeighbor(element.y, 0);
-			addNeighbor(element.y - 1, 0);
-			addNeighbor(element.y + 1, 0);
-			break;
+void Board::StartRecording(const std::string & fileName, uint64_t generation) {
+	StopRecording();
+	m_log = new GenerationLog(fileName, m_simulation, m_neighborTable.GetNumElements(), generation);
+}
 
-		case BoardSides::SOUTH: //3
-			tempSide = BoardSides::EAST;
+void Board::StopRecording(void) {
+	delete m_log;
+	m_log = nullptr;
+}
 
-			addNeighbor(element.y, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.y - 1, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.y + 1, m_sides[tempSide]->GetSize().y - 1);
-			break;
+bool Board::IsRecording(void) const {
+	return m_log;
+}
 
-		case BoardSides::EAST: //4
-			tempSide = BoardSides::SOUTH;
+uint64_t Board::StartReplay(const std::string & fileName) {
+	GenerationReplay * replay = new GenerationReplay(fileName, m_neighborTable.GetNumElements());
+	try {
+		replay->Start(m_simulation); //board is only changed once the start of the log has been checked
+	} catch (...) {
+		delete replay;
+		throw;
+	}
+	StopReplay();
+	m_replay = replay;
 
-			addNeighbor(element.y, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.y - 1, m_sides[tempSide]->GetSize().y - 1);
-			addNeighbor(element.y + 1, m_sides[tempSide]->GetSize().y - 1);
-			break;
+	RefreshTypes();
+	m_history.Clear(m_simulation, m_replay->GetGeneration());
+	m_cycleDetector.Reset(m_simulation, m_neighborTable.GetNumElements());
+	return m_replay->GetGeneration();
+}
 
-		case BoardSides::WEST: //5
-			tempSide = BoardSides::SOUTH;
+void Board::StopReplay(void) {
+	delete m_replay;
+	m_replay = nullptr;
+}
 
-			addNeighbor(element.y, 0);
-			addNeighbor(element.y - 1, 0);
-			addNeighbor(element.y + 1, 0);
-			break;
+bool Board::IsReplaying(void) const {
+	return m_replay;
+}
 
-		default:
-			throw std::string("Invalid element face number:" + glm::to_string(element));
-		}
-	}
+//score is elements alive or dying of each player
+glm::uvec2 Board::GetScore(void) const {
+	const unsigned int * counts = m_typeCounts[m_publishedTypes.load(std::memory_order_acquire)];
+	return glm::uvec2(counts[P1_ALIVE] + counts[P1_DEAD_FUTURE], counts[P2_ALIVE] + counts[P2_DEAD_FUTURE]);
+}
 
-	//weird corner cases
-	if (element == glm::uvec3(1, 19, 0))
-		neighbors.emplace_back(3, 19, 0);
-	else if (element == glm::uvec3(1, 1, 0))
-		neighbors.emplace_back(2, 19, 0);
-	else if (element == glm::uvec3(1, 0, 19))
-		neighbors.emplace_back(4, 19, 0);
-	else if (element == glm::uvec3(1, 20, 19))
-		neighbors.emplace_back(4, 19, 20);
-	else if (element == glm::uvec3(2, 19, 0))
-		neighbors.emplace_back(1, 1, 0);
-	else if (element == glm::uvec3(2, 0, 19))
-		neighbors.emplace_back(4, 0, 1);
-	else if (element == glm::uvec3(3, 0, 1))
-		neighbors.emplace_back(5, 0, 18);
-	else if (element == glm::uvec3(3, 19, 0))
-		neighbors.emplace_back(1, 19, 0);
-	else if (element == glm::uvec3(4, 19, 0))
-		neighbors.emplace_back(1, 0, 19);
-	else if (element == glm::uvec3(4, 19, 20))
-		neighbors.emplace_back(1, 20, 19);
-	else if (element == glm::uvec3(5, 0, 18))
-		neighbors.emplace_back(3, 0, 18);
+unsigned int Board::GetTypeCount(const ObjType type) const {
+	return m_typeCounts[m_publishedTypes.load(std::memory_order_acquire)][type];
+}
 
-	return neighbors;
+const std::vector<glm::uvec2> & Board::GetPopulationHistory(void) const {
+	return m_populationHistory;
 }
 
-//get current status of game element. element = {face - BoardSides enumeration, row, column}
-ObjType Board::GetGameElementType(const glm::uvec3 & element) const {
-#ifdef DEBUG
-	printf("\nGetting element type for element: |%s|\n", glm::to_string(element).c_str());
-#endif
-	return m_sides[element.x]->GetType(element.y, element.z);
+void Board::ClearPopulationHistory(void) {
+	PickUpGeneration();
+	m_populationHistory.clear();
+	m_populationHistory.push_back(GetPopulation(m_publishedTypes.load(std::memory_order_acquire)));
 }
 
-//set currents status of game element. element = {face - BoardSides enumeration, row, column}
-void Board::SetGameElementType(const glm::uvec3 & element, const ObjType type) {
-#ifdef DEBUG
-	printf("\nSetting element |%s| to type: %i\n", glm::to_string(element).c_str(), type);
-#endif
-	m_sides[element.x]->SetType(element.y, element.z, type);
+//population is elements alive or being born of each player
+glm::uvec2 Board::GetPopulation(unsigned int buffer) const {
+	const unsigned int * counts = m_typeCounts[buffer];
+	return glm::uvec2(counts[P1_ALIVE] + counts[P1_ALIVE_FUTURE], counts[P2_ALIVE] + counts[P2_ALIVE_FUTURE]);
 }
 
-glm::uvec3 Board::GetNextGameElement(const glm::uvec3 & currentElement) const {
-	if (m_sides[currentElement.x]->IsValidElement(glm::uvec2(currentElement.y, currentElement.z + 1))) //try next element in row
-		return glm::uvec3(currentElement.x, currentElement.y, currentElement.z + 1);
-	else if (m_sides[currentElement.x]->IsValidElement(glm::uvec2(currentElement.y + 1, 0))) //try next row
-		return glm::uvec3(currentElement.x, currentElement.y + 1, 0);
-	else if (currentElement.x + 1 < BoardSides::NUM_SIDES) //try next face
-		return glm::uvec3(currentElement.x + 1, 0, 0);
-	else
-		return glm::uvec3(0, 0, 0); //done go back to first element
+void Board::RefreshTypes(void) {
+	PickUpGeneration(); //rendered generation has to be newest one so it can be uploaded right away
+
+	unsigned int published = m_publishedTypes.load(std::memory_order_acquire);
+	std::vector<ObjType> & types = m_types[published];
+	m_simulation.WriteTypes(&types[0]);
+
+	unsigned int * counts = m_typeCounts[published];
+	std::fill(counts, counts + ObjType::NUM_TYPES, 0);
+	for (ObjType type : types)
+		++counts[type];
+
+	glBindBuffer(GL_TEXTURE_BUFFER, m_typeBuffer);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0, types.size() * sizeof(ObjType), &types[0]);
 }
 
-glm::uvec2 Board::GetScore(void) const {
-	glm::uvec3 tempElement(0, 0, 0);
-	glm::uvec2 score(0, 0);
+//changes close together are merged so uploads stay few
+void Board::FindChangedTypes(unsigned int from, unsigned int to) {
+	const ObjType * before = &m_types[from][0], *after = &m_types[to][0];
+	const unsigned int numElements = m_types[to].size();
 
-	do { //go through all the elements
-		ObjType tempElementType = GetGameElementType(tempElement);
+	std::vector<glm::uvec2> & ranges = m_changedTypes[to];
+	ranges.clear();
 
-		if (tempElementType == P1_ALIVE || tempElementType == P1_DEAD_FUTURE)
-			++score.x;
-		else if (tempElementType == P2_ALIVE || tempElementType == P2_DEAD_FUTURE)
-			++score.y;
+	//type counts follow the changes
+	unsigned int * counts = m_typeCounts[to];
+	std::copy(m_typeCounts[from], m_typeCounts[from] + ObjType::NUM_TYPES, counts);
 
-		tempElement = GetNextGameElement(tempElement); //go to next element
-	} while (tempElement != glm::uvec3(0, 0, 0)); //check if all have been iterated through
+	unsigned int i = 0;
+	while (i < numElements) {
+		//skip over unchanged blocks quickly
+		if (i % 64 == 0 && i + 64 <= numElements && !std::memcmp(before + i, after + i, 64 * sizeof(ObjType))) {
+			i += 64;
+			continue;
+		}
+		if (before[i] == after[i]) {
+			++i;
+			continue;
+		}
 
-	return score;
+		unsigned int begin = i, lastChanged = i;
+		--counts[before[i]];
+		++counts[after[i]];
+		while (++i < numElements && i - lastChanged <= TYPE_UPLOAD_MERGE_GAP) {
+			if (before[i] != after[i]) {
+				lastChanged = i;
+				--counts[before[i]];
+				++counts[after[i]];
+			}
+		}
+		ranges.push_back(glm::uvec2(begin, lastChanged + 1));
+		i = lastChanged + 1;
+	}
 }
 
 //rounds everything to be in range [min, max]
@@ -537,89 +626,62 @@ void Board::EnforceBounds(glm::vec3 & v, float min, float max) {
 		v.z = max;
 }
 
-void Board::InitializeBullet(void) {
-#ifdef DEBUG
-	printf("Initializing Bullet!\n");
-#endif
-
-	//initialize bullet world
-	m_broadphase = new btDbvtBroadphase();
-	m_collisionConfiguration = new btDefaultCollisionConfiguration();
-	m_dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
-	m_solver = new btSequentialImpulseConstraintSolver();
-	m_dynamicsWorld = new btDiscreteDynamicsWorld(m_dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
-	m_dynamicsWorld->setGravity(btVector3(0, 0, 0));
-
-	LoadColliders(); //load colliders
-}
-
-//for loading each face of game
-void Board::LoadColliders(void) {
-
-#ifdef DEBUG
-	printf("Setting cube positions...\n");
-#endif
-
-	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i) {
-
-#ifdef DEBUG
-		printf("Setting side %i...\n", i);
-#endif
-		std::vector < glm::vec3 > positions = m_sides[i]->GetInstancePositions();
-
-		for (const glm::vec3 & pos : positions)
-			AddCubeColliderToWorld(pos, m_sides[i]->GetRotation(), m_sides[i]->GetScale());
+//elements of a face are boxes at translation + row * changeRow + col * changeCol. Work in coordinates along {row, column, normal} of face
+//only rows the ray passes through and the columns it crosses in each row are tested, so cost does not grow with face size
+bool Board::RaycastFace(unsigned int face, const glm::vec3 & start, const glm::vec3 & direction, float & distance, glm::uvec2 & element) const {
+	const Object * side = m_sides[face];
+	const glm::uvec2 size = side->GetSize();
+	const glm::vec3 axes[3] = { glm::normalize(side->GetChangeRow()), glm::normalize(side->GetChangeCol()), side->GetNormal() };
+	const glm::vec2 spacing(glm::length(side->GetChangeRow()), glm::length(side->GetChangeCol()));
+
+	glm::vec3 origin, dir, halfSize;
+	for (unsigned int k = 0; k < 3; ++k) {
+		origin[k] = glm::dot(start - side->GetTranslation(), axes[k]);
+		dir[k] = glm::dot(direction, axes[k]);
+		halfSize[k] = glm::dot(glm::abs(axes[k]), side->GetScale());
 	}
-}
-
-//for adding cube collider to bullet world
-void Board::AddCubeColliderToWorld(const glm::vec3 & position, const glm::vec3 & rotation, const glm::vec3 & scale) {
-	btCollisionShape * collider = new btBoxShape(btVector3(scale.x, scale.y, scale.z));
-	btQuaternion rotQuat = btQuaternion::getIdentity();
-	rotQuat.setEuler(rotation.y, rotation.x, rotation.z);
-	btDefaultMotionState * startTransform = new btDefaultMotionState(btTransform(rotQuat, { position.x, position.y, position.z })); //rotation and position
-	btScalar mass = 0;
-	btVector3 inertia(0, 0, 0);
-	collider->calculateLocalInertia(mass, inertia);
-	btRigidBody * rigidBody = new btRigidBody(btRigidBody::btRigidBodyConstructionInfo(mass, startTransform, collider, inertia)); //and thus the rigidbody was born
-//rigidBody->setGravity({0, 0, 0});
-//rigidBody->setActivationState(0);//ensuring it doesn't move no matter what, sleeping objects should still be hit with a raycast
-	rigidBody->setSleepingThresholds(0, 0);
-	m_dynamicsWorld->addRigidBody(rigidBody); //I might be able to improve this by simply using dynamicsWorld->addCollisionObject(), but i'm a tad skeptical, and this should work fine
-	m_rigidBodies.push_back(rigidBody);
-
-#ifdef DEBUG
-	printf("Cube Collider placed at location |%s| with scale |%s|\n", glm::to_string(position).c_str(), glm::to_string(scale).c_str());
-#endif
-}
 
-//helper function to get neighbors in same side as object
-void Board::FindElementNeighborsInFace(std::vector<glm::uvec3> & neighbors, const glm::uvec3 & element) const {
-	glm::uvec2 faceSize = m_sides[element.x]->GetSize();
-
-	//get neighbors in previous row
-	if (element.y > 0) {
-		neighbors.emplace_back(element.x, element.y - 1, element.z);
-		if (element.z > 0)
-			neighbors.emplace_back(element.x, element.y - 1, element.z - 1);
-		if (element.z < faceSize.y - 1)
-			neighbors.emplace_back(element.x, element.y - 1, element.z + 1);
-	}
+	//part of ray where coordinate k is within [low, high]
+	auto clipRay = [&origin, &dir](unsigned int k, float low, float high, float & tMin, float & tMax)->bool {
+		if (std::abs(dir[k]) < 1e-6f)
+			return origin[k] >= low && origin[k] <= high;
+		float t1 = (low - origin[k]) / dir[k], t2 = (high - origin[k]) / dir[k];
+		tMin = std::max(tMin, std::min(t1, t2));
+		tMax = std::min(tMax, std::max(t1, t2));
+		return tMin <= tMax;
+	};
 
-	//get neighbors in next row
-	if (element.y < faceSize.x - 1) {
-		neighbors.emplace_back(element.x, element.y + 1, element.z);
-		if (element.z > 0)
-			neighbors.emplace_back(element.x, element.y + 1, element.z - 1);
-		if (element.z < faceSize.y - 1)
-			neighbors.emplace_back(element.x, element.y + 1, element.z + 1);
+	//part of ray inside the slab holding the face
+	float slabMin = 0.f, slabMax = PICK_DISTANCE;
+	if (!clipRay(2, -halfSize.z, halfSize.z, slabMin, slabMax))
+		return false;
+
+	//rows crossed inside the slab
+	float rowCoords[2] = { origin.x + dir.x * slabMin, origin.x + dir.x * slabMax };
+	int rowBegin = std::max(0, int(std::ceil((std::min(rowCoords[0], rowCoords[1]) - halfSize.x) / spacing.x)));
+	int rowEnd = std::min(int(size.x) - 1, int(std::floor((std::max(rowCoords[0], rowCoords[1]) + halfSize.x) / spacing.x)));
+
+	bool found = false;
+	distance = PICK_DISTANCE;
+	for (int r = rowBegin; r <= rowEnd; ++r) {
+		float rowMin = slabMin, rowMax = slabMax;
+		if (!clipRay(0, r * spacing.x - halfSize.x, r * spacing.x + halfSize.x, rowMin, rowMax))
+			continue;
+
+		//columns crossed in this row
+		float colCoords[2] = { origin.y + dir.y * rowMin, origin.y + dir.y * rowMax };
+		int colBegin = std::max(0, int(std::ceil((std::min(colCoords[0], colCoords[1]) - halfSize.y) / spacing.y)));
+		int colEnd = std::min(int(size.y) - 1, int(std::floor((std::max(colCoords[0], colCoords[1]) + halfSize.y) / spacing.y)));
+
+		for (int c = colBegin; c <= colEnd; ++c) {
+			float tMin = rowMin, tMax = rowMax;
+			if (clipRay(1, c * spacing.y - halfSize.y, c * spacing.y + halfSize.y, tMin, tMax) && tMin < distance) {
+				distance = tMin;
+				element = glm::uvec2(r, c);
+				found = true;
+			}
+		}
 	}
 
-	//get neighbors in previous column
-	if (element.z > 0)
-		neighbors.emplace_back(element.x, element.y, element.z - 1);
-
-	//get neighbors in next column
-	if (element.z < faceSize.y - 1)
-		neighbors.emplace_back(element.x, element.y, element.z + 1);
+	return found;
 }
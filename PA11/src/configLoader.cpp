@@ -1,4 +1,5 @@
 #include "configLoader.hpp"
+#include "cubeBoard.h"
 
 #include <fstream>
 
@@ -39,6 +40,23 @@ void ConfigFileParser::GetWindowInfo(std::string & windowName, glm::uvec2 & size
 	size = (fullscreen) ? glm::uvec2(0, 0) : glm::uvec2(winSize[0], winSize[1]); //set windowsize to 0 if in fullscreen
 }
 
+void ConfigFileParser::GetPacingInfo(PacingMode & mode, float & frameCap) {
+	std::string varName, modeName;
+	if (!ParseLine < std::string > (varName, &modeName) || varName.compare("WINDOW_PACING"))
+		throw std::string("Could not get frame pacing from config file");
+
+	const char * modeNames[NUM_PACING_MODES] = { "UNCAPPED", "VSYNC", "ADAPTIVE", "CAPPED" };
+	unsigned int i = 0;
+	while (i < NUM_PACING_MODES && modeName.compare(modeNames[i]))
+		++i;
+	if (i == NUM_PACING_MODES)
+		throw std::string("Frame pacing in config file has to be UNCAPPED, VSYNC, ADAPTIVE or CAPPED");
+	mode = PacingMode(i);
+
+	if (!ParseLine<float>(varName, &frameCap) || varName.compare("WINDOW_FRAME_CAP") || frameCap <= 0.f)
+		throw std::string("Could not get frame cap from config file");
+}
+
 void ConfigFileParser::GetCameraInfo(glm::vec3 & eyePos, glm::vec3 & eyeLoc) {
 	std::string varName;
 	float values[3];
@@ -54,7 +72,7 @@ void ConfigFileParser::GetCameraInfo(glm::vec3 & eyePos, glm::vec3 & eyeLoc) {
 	eyeLoc = glm::vec3(values[0], values[1], values[2]);
 }
 
-void ConfigFileParser::GetMenuState(bool & menu, glm::uvec2 & size) {
+void ConfigFileParser::GetMenuState(bool & menu, glm::uvec2 & size, bool & ownWindow) {
 	std::string varName;
 	if (!ParseLine<bool>(varName, &menu) || varName.compare("ENABLE_MENU"))
 		throw std::string("Could not get menu state from config file");
@@ -64,6 +82,10 @@ void ConfigFileParser::GetMenuState(bool & menu, glm::uvec2 & size) {
 	if (!ParseLine<unsigned int, 2>(varName, winSize) || varName.compare("MENU_SIZE"))
 		throw std::string("Could not get menu size from config file");
 	size = glm::uvec2(winSize[0], winSize[1]);
+
+	//menu is drawn over the main window unless it gets a window of its own
+	if (!ParseLine<bool>(varName, &ownWindow) || varName.compare("MENU_WINDOW"))
+		throw std::string("Could not get menu window mode from config file");
 }
 
 void ConfigFileParser::GetGameInfo(GameInfo & game) {
@@ -99,6 +121,12 @@ void ConfigFileParser::GetGameInfo(GameInfo & game) {
 	if (!ParseLine<float>(varName, &game.m_object.m_shininess) || varName.compare("OBJ_SHININESS"))
 		throw std::string("Could not get shiniess from config file");
 
+	//get mesh drawn for every element
+	std::string mesh;
+	if (!ParseLine < std::string > (varName, &mesh) || varName.compare("OBJ_MESH") || (mesh.compare("QUADS") && mesh.compare("OBJECT")))
+		throw std::string("Could not get mesh (QUADS or OBJECT) from config file");
+	game.m_object.m_faceQuads = !mesh.compare("QUADS");
+
 	//get ambient level
 	if (!ParseLine<float, 3>(varName, valuesfl) || varName.compare("AMBIENT_LEVEL"))
 		throw std::string("Could not get ambient level from config file");
@@ -128,8 +156,16 @@ void ConfigFileParser::GetGameInfo(GameInfo & game) {
 	if (!ParseLine < std::string > (varName, &game.m_textures[10]) || varName.compare("TEXTURE_P2_DEAD_MARKED"))
 		throw std::string("Could not get texture 10 for dead from config file");
 
+	//get size of cube board - sides are generated from it unless it is 0
+	if (!ParseLine<unsigned int>(varName, &game.m_boardEdge) || varName.compare("BOARD_EDGE"))
+		throw std::string("Could not get board edge from config file");
+	if (!ParseLine<float>(varName, &game.m_boardSpacing) || varName.compare("BOARD_SPACING"))
+		throw std::string("Could not get board spacing from config file");
+	if (game.m_boardEdge)
+		GenerateCubeBoard(game.m_boardEdge, game.m_boardSpacing, game.m_sides);
+
 	//get various sides of board
-	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i) {
+	for (unsigned int i = 0; i < BoardSides::NUM_SIDES && !game.m_boardEdge; ++i) {
 
 		//get board name
 		if (!ParseLine<unsigned int>(varName, valuesui) || varName.compare("BOARD_SIDE") || valuesui[0] != i)
@@ -151,6 +187,30 @@ void ConfigFileParser::GetGameInfo(GameInfo & game) {
 			throw std::string("Could not get board column direction from config file");
 		game.m_sides[i].m_changeCol = glm::vec3(valuesfl[0], valuesfl[1], valuesfl[2]);
 	}
+
+	//get number of threads used for simulation
+	if (!ParseLine<unsigned int>(varName, &game.m_simulationThreads) || varName.compare("SIMULATION_THREADS"))
+		throw std::string("Could not get number of simulation threads from config file");
+
+	//get rule of the game
+	std::string rule;
+	if (!ParseLine < std::string > (varName, &rule) || varName.compare("LIFE_RULE"))
+		throw std::string("Could not get life rule from config file");
+	game.m_rule = ParseLifeRule(rule);
+
+	//get autoplay speed
+	if (!ParseLine<float>(varName, &game.m_autoplayRate) || varName.compare("AUTOPLAY_RATE") || game.m_autoplayRate < 0)
+		throw std::string("Could not get autoplay rate from config file");
+
+	//get memory kept for rewinding
+	if (!ParseLine<unsigned int>(varName, &game.m_historySize) || varName.compare("HISTORY_SIZE"))
+		throw std::string("Could not get history size from config file");
+
+	//get how hard the computer player thinks
+	if (!ParseLine<unsigned int>(varName, &game.m_aiLookahead) || varName.compare("AI_LOOKAHEAD"))
+		throw std::string("Could not get AI lookahead from config file");
+	if (!ParseLine<unsigned int>(varName, &game.m_aiTimeBudget) || varName.compare("AI_TIME_BUDGET"))
+		throw std::string("Could not get AI time budget from config file");
 }
 
 void ConfigFileParser::GetShaderSet(std::string & shaderSetName, std::string & vertexShaderFile, std::string & fragmentShaderFile) {
@@ -0,0 +1,25 @@
+#include "cubeBoard.h"
+
+//faces of a cube with points 0 ... n - 1 along each axis (n = edge). Rows & columns run along the axes given
+//floor (y = 0):     rows x = 1 ... n - 2, columns z = 1 ... n - 2
+//roof (y = n - 1):  rows x = 0 ... n - 1, columns z = 0 ... n - 2
+//north (x = 0):     rows y = 0 ... n - 2, columns z = 0 ... n - 2
+//south (x = n - 1): rows y = 0 ... n - 2, columns z = 0 ... n - 2
+//east (z = n - 1):  rows y = 0 ... n - 1, columns x = 0 ... n - 1
+//west (z = 0):      rows y = 0 ... n - 2, columns x = 1 ... n - 2
+void GenerateCubeBoard(unsigned int edge, float spacing, BoardInfo (&sides)[BoardSides::NUM_SIDES]) {
+	if (edge < CUBE_BOARD_MIN_EDGE)
+		throw std::string("Edge of cube board has to be at least " + std::to_string(CUBE_BOARD_MIN_EDGE) + " elements: " + std::to_string(edge));
+	if (!(spacing > 0.f))
+		throw std::string("Spacing of cube board has to be positive: " + std::to_string(spacing));
+
+	const float far = (edge - 1) * spacing; //position of the far side of the cube
+	const glm::vec3 x(spacing, 0.f, 0.f), y(0.f, spacing, 0.f), z(0.f, 0.f, spacing);
+
+	sides[BoardSides::FLOOR] = { "Floor", glm::uvec2(edge - 2, edge - 2), x + z, x, z };
+	sides[BoardSides::ROOF] = { "Roof", glm::uvec2(edge, edge - 1), glm::vec3(0.f, far, 0.f), x, z };
+	sides[BoardSides::NORTH] = { "North", glm::uvec2(edge - 1, edge - 1), glm::vec3(0.f, 0.f, 0.f), y, z };
+	sides[BoardSides::SOUTH] = { "South", glm::uvec2(edge - 1, edge - 1), glm::vec3(far, 0.f, 0.f), y, z };
+	sides[BoardSides::EAST] = { "East", glm::uvec2(edge, edge), glm::vec3(0.f, 0.f, far), y, x };
+	sides[BoardSides::WEST] = { "West", glm::uvec2(edge - 1, edge - 2), x, y, x };
+}
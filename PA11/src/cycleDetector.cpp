@@ -0,0 +1,70 @@
+#include "cycleDetector.h"
+
+CycleDetector::CycleDetector(void) :
+		m_hash(0), m_numGenerations(0), m_period(0) {
+}
+
+CycleDetector::~CycleDetector(void) {
+}
+
+void CycleDetector::Reset(const LifeSimulation & simulation, unsigned int numElements) {
+	m_hash = 0;
+	for (unsigned int i = 0; i < numElements; ++i)
+		m_hash ^= GetKey(i, simulation.GetState(i));
+
+	m_numGenerations = 0;
+	m_period = 0;
+}
+
+//board was changed by hand, so it may not repeat anymore - checked again with the next generation
+void CycleDetector::AddEdit(unsigned int index, uint8_t oldState, uint8_t newState) {
+	m_hash ^= GetKey(index, oldState) ^ GetKey(index, newState);
+	m_period = 0;
+}
+
+void CycleDetector::AddGeneration(const LifeSimulation & simulation, const std::vector<uint32_t> & indices,
+		const std::vector<uint8_t> & states) {
+	m_hashes[m_numGenerations % CYCLE_MAX_PERIOD] = m_hash;
+	++m_numGenerations;
+
+	for (unsigned int i = 0; i < indices.size(); ++i)
+		m_hash ^= GetKey(indices[i], simulation.GetLastState(indices[i])) ^ GetKey(indices[i], states[i]);
+
+	//shortest period wins - a board repeating every 2 generations repeats every 4 as well
+	m_period = 0;
+	for (unsigned int p = 1; p <= CYCLE_MAX_PERIOD && p <= m_numGenerations; ++p) {
+		if (m_hashes[(m_numGenerations - p) % CYCLE_MAX_PERIOD] == m_hash) {
+			m_period = p;
+			break;
+		}
+	}
+}
+
+bool CycleDetector::Rewind(unsigned int generations) {
+	if (!generations || generations > m_numGenerations || generations > CYCLE_MAX_PERIOD)
+		return false;
+
+	m_numGenerations -= generations;
+	m_hash = m_hashes[m_numGenerations % CYCLE_MAX_PERIOD];
+	m_period = 0; //checked again with the next generation
+	return true;
+}
+
+unsigned int CycleDetector::GetPeriod(void) const {
+	return m_period;
+}
+
+uint64_t CycleDetector::GetHash(void) const {
+	return m_hash;
+}
+
+//splitmix64 of element & state - keys are the same on every run without storing a table
+uint64_t CycleDetector::GetKey(unsigned int index, uint8_t state) {
+	if (!(state & LIFE_STATE_ALIVE))
+		return 0;
+
+	uint64_t key = (uint64_t(index) << 2 | state) + 0x9E3779B97F4A7C15ull;
+	key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+	key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+	return key ^ (key >> 31);
+}
@@ -1,12 +1,12 @@
 #include "engine.h"
+#include "trace.h"
 
 #include <chrono>
-#include <assert.h>
 
-Engine::Engine(const std::string & launchFile, float frameCap) :
-		m_window(nullptr), m_graphics(nullptr), m_configFile(launchFile), m_shift(false), m_w(false), m_a(false), m_s(false), m_d(false), m_spacebar(
-				false), m_leftShift(false), m_captureMouse(true), m_mouseWarp(true), m_menu(nullptr), m_menuSize(0, 0), m_menuLastTime(0), m_dt(0), m_currentTimeMillis(
-				Engine::GetCurrentTimeMillis()), m_running(false), m_minFrameTime(1.0f / frameCap * 1000) {
+Engine::Engine(const std::string & launchFile) :
+		m_window(nullptr), m_graphics(nullptr), m_pacer(nullptr), m_configFile(launchFile), m_shift(false), m_w(false), m_a(false), m_s(false), m_d(false), m_spacebar(
+				false), m_leftShift(false), m_captureMouse(true), m_mouseWarp(true), m_menu(nullptr), m_menuSize(0, 0), m_menuWindow(false), m_menuLastTime(0), m_dt(0), m_lastFrame(
+				std::chrono::steady_clock::now()), m_running(false) {
 	std::srand(time(nullptr));
 
 	//get window parameters and start the window
@@ -15,13 +15,20 @@ Engine::Engine(const std::string & launchFile, float frameCap) :
 	m_configFile.GetWindowInfo(windowName, windowSize);
 	m_window = new Window(windowName, windowSize.x, windowSize.y);
 
+	//get frame pacing - needs the OpenGL context of the window
+	PacingMode pacingMode;
+	float frameCap;
+	m_configFile.GetPacingInfo(pacingMode, frameCap);
+	m_pacer = new FramePacer(pacingMode, frameCap);
+	m_pacer->Initialize();
+
 	//get camera information for configuration file
 	glm::vec3 eyePos, eyeLoc;
 	m_configFile.GetCameraInfo(eyePos, eyeLoc);
 
 	//check if menu needs to be initialized
 	bool menu;
-	m_configFile.GetMenuState(menu, m_menuSize);
+	m_configFile.GetMenuState(menu, m_menuSize, m_menuWindow);
 
 	//get board information from configuration file
 	GameInfo game;
@@ -45,21 +52,22 @@ Engine::Engine(const std::string & launchFile, float frameCap) :
 Engine::~Engine(void) {
 	delete m_menu;
 	delete m_graphics;
+	delete m_pacer;
 }
 
 void Engine::Run(void) {
 	m_running = true;
 
-	//variables to measure & enforce framerate
-	std::chrono::high_resolution_clock::time_point t1, t2;
-	float duration;
-
+	TRACE_THREAD_NAME("Main");
 	while (m_running) {
+		TRACE_SCOPE("Frame");
 
-		t1 = std::chrono::high_resolution_clock::now();
 		SDL_GL_MakeCurrent(m_window->GetWindow(), m_window->GetContext());
 
-		EventChecker(); // Check for events input
+		{
+			TRACE_SCOPE("Events");
+			EventChecker(); // Check for events input
+		}
 
 		// Update and render the graphics
 		m_dt = GetDT();
@@ -80,31 +88,41 @@ void Engine::Run(void) {
 			m_graphics->MoveDown(0.01 * m_dt);
 
 		//update graphics worls
-		m_graphics->Update(m_dt);
-		m_graphics->Render();
+		{
+			TRACE_SCOPE("Update");
+			m_graphics->Update(m_dt);
+		}
+		{
+			TRACE_SCOPE("Render");
+			m_graphics->Render();
+		}
 
-		// Swap to the Window
-		m_window->Swap();
+		//update menu and change variables if necessary - before the swap, so the overlay is presented with the frame it is drawn over
+		if (m_menu) {
+			TRACE_SCOPE("Menu");
+			if (m_menu->Update(m_window->GetContext(), m_graphics->GetEyePos(), m_graphics->GetEyeFocus(), *m_pacer))
+				m_graphics->UpdateCamera(m_menu->GetEyeLocation(), m_menu->GetEyeFocus());
+		}
 
-		//update menu and change variables if necessary
-		if (m_menu && m_menu->Update(m_window->GetContext(), m_graphics->GetEyePos(), m_graphics->GetEyeFocus()))
-			m_graphics->UpdateCamera(m_menu->GetEyeLocation(), m_menu->GetEyeFocus());
+		// Swap to the Window
+		{
+			TRACE_SCOPE("Swap");
+			m_window->Swap();
+		}
 
+		m_pacer->EndFrame();
 	}
 
-	//enforce max frame rate
-	t2 = std::chrono::high_resolution_clock::now();
-	duration = std::chrono::duration_cast < std::chrono::milliseconds > (t2 - t1).count();
-	if (duration < m_minFrameTime)
-		SDL_Delay(m_minFrameTime - duration);
+#ifdef USE_TRACING
+	WriteTrace();
+#endif
 }
 
-unsigned int Engine::GetDT(void) {
-	long long TimeNowMillis = Engine::GetCurrentTimeMillis();
-	assert(TimeNowMillis >= m_currentTimeMillis);
-	unsigned int DeltaTimeMillis = (unsigned int) (TimeNowMillis - m_currentTimeMillis);
-	m_currentTimeMillis = TimeNowMillis;
-	return DeltaTimeMillis;
+float Engine::GetDT(void) {
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	float dt = std::chrono::duration<float, std::milli>(now - m_lastFrame).count();
+	m_lastFrame = now;
+	return dt;
 }
 
 long long Engine::GetCurrentTimeMillis() {
@@ -134,10 +152,10 @@ void Engine::EventChecker(void) {
 		if (event.window.windowID == SDL_GetWindowID(m_window->GetWindow())) {
 			if (event.window.event == SDL_WINDOWEVENT_CLOSE) { //quits if main window is closed
 				m_running = false;
-			} else {
+			} else if (!m_menu || m_menu->HasWindow() || !m_menu->HandleEvent(event)) { //overlay menu gets first pick
 				HandleEvent(event);
 			}
-		} else if (m_menu && event.window.windowID == SDL_GetWindowID(m_menu->GetWindow())) {
+		} else if (m_menu && m_menu->HasWindow() && event.window.windowID == SDL_GetWindowID(m_menu->GetWindow())) {
 			if (event.window.event == SDL_WINDOWEVENT_CLOSE
 					|| (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_t && m_menuLastTime + 500 < Engine::GetCurrentTimeMillis()))
 				CloseMenu();
@@ -145,7 +163,10 @@ void Engine::EventChecker(void) {
 					|| event.key.keysym.sym == SDLK_l || event.key.keysym.sym == SDLK_w || event.key.keysym.sym == SDLK_s
 					|| event.key.keysym.sym == SDLK_a || event.key.keysym.sym == SDLK_d || event.key.keysym.sym == SDLK_SPACE
 					|| event.key.keysym.sym == SDLK_LSHIFT || event.key.keysym.sym == SDLK_c || event.key.keysym.sym == SDLK_p
-					|| event.key.keysym.sym == SDLK_g || event.key.keysym.sym == SDLK_n)
+					|| event.key.keysym.sym == SDLK_g || event.key.keysym.sym == SDLK_n || event.key.keysym.sym == SDLK_F5
+					|| event.key.keysym.sym == SDLK_F6 || event.key.keysym.sym == SDLK_F9 || event.key.keysym.sym == SDLK_F10
+					|| event.key.keysym.sym == SDLK_LEFT || event.key.keysym.sym == SDLK_DOWN || event.key.keysym.sym == SDLK_b
+					|| event.key.keysym.sym == SDLK_F12)
 				HandleEvent(event);
 			else
 				m_menu->HandleEvent(event);
@@ -207,6 +228,8 @@ void Engine::HandleEvent(const SDL_Event & event) {
 				SDL_SetRelativeMouseMode (SDL_FALSE);
 				SDL_WarpMouseInWindow(nullptr, m_window->GetWindowWidth() / 2, m_window->GetWindowHeight() / 2);
 			}
+			if (m_menu)
+				m_menu->UseMouse(!m_captureMouse);
 		} else if (event.key.keysym.sym == SDLK_p) {
 			if (!m_graphics->IsGenerating())
 				m_graphics->MoveForwardGeneration();
@@ -215,7 +238,22 @@ void Engine::HandleEvent(const SDL_Event & event) {
 				m_graphics->StopAutoplay();
 			else
 				m_graphics->StartAutoplay();
-		}
+		} else if (event.key.keysym.sym == SDLK_F5)
+			m_graphics->SaveSnapshot();
+		else if (event.key.keysym.sym == SDLK_F9)
+			m_graphics->LoadSnapshot();
+		else if (event.key.keysym.sym == SDLK_F6)
+			m_graphics->ToggleRecording();
+		else if (event.key.keysym.sym == SDLK_F10)
+			m_graphics->ToggleReplay();
+		else if (event.key.keysym.sym == SDLK_LEFT)
+			m_graphics->Rewind(1);
+		else if (event.key.keysym.sym == SDLK_DOWN)
+			m_graphics->Rewind(HISTORY_KEYFRAME_INTERVAL);
+		else if (event.key.keysym.sym == SDLK_b)
+			m_graphics->ToggleAIOpponent();
+		else if (event.key.keysym.sym == SDLK_F12)
+			WriteTrace();
 	} else if (event.type == SDL_KEYUP) {
 		if (event.key.keysym.sym == SDLK_w)
 			m_w = false;
@@ -237,7 +275,7 @@ void Engine::HandleEvent(const SDL_Event & event) {
 		} else {
 			m_mouseWarp = false;
 		}
-	} else if (event.type == SDL_MOUSEBUTTONDOWN && !m_graphics->IsGenerating()) {
+	} else if (event.type == SDL_MOUSEBUTTONDOWN && !m_graphics->IsGenerating() && !m_graphics->IsAutoplaying()) { //autoplay can start a generation any time
 		if (event.button.button == SDL_BUTTON_LEFT) {
 			if (!m_captureMouse)
 				m_graphics->LeftClick(glm::vec2((float) event.button.x, (float) event.button.y));
@@ -249,7 +287,8 @@ void Engine::HandleEvent(const SDL_Event & event) {
 
 bool Engine::StartMenu(const glm::vec3 & eyePos, const glm::vec3 & eyeLoc) {
 	try {
-		m_menu = new Menu(m_window->GetContext(), eyePos, eyeLoc, m_menuSize);
+		m_menu = new Menu(m_window->GetWindow(), m_window->GetContext(), eyePos, eyeLoc, m_menuSize, m_menuWindow);
+		m_menu->UseMouse(!m_captureMouse);
 		m_menuLastTime = Engine::GetCurrentTimeMillis();
 		return true;
 	} catch (...) {
@@ -260,6 +299,15 @@ bool Engine::StartMenu(const glm::vec3 & eyePos, const glm::vec3 & eyeLoc) {
 	}
 }
 
+void Engine::WriteTrace(void) {
+#ifdef USE_TRACING
+	if (!TRACE_WRITE(TRACE_FILE))
+		printf("\nCould not write trace to %s\n", TRACE_FILE);
+#else
+	printf("\nTracing is not compiled in - build with USE_TRACING=ON to record a trace\n");
+#endif
+}
+
 bool Engine::CloseMenu(void) {
 	delete m_menu;
 	m_menu = nullptr;
@@ -0,0 +1,237 @@
+#include "generationHistory.h"
+
+#include <cstring>
+#include <algorithm>
+
+//bytes of a delta with n elements - entries start on 8 bytes & are never empty, so no two start at the same place
+static size_t GetDeltaSize(size_t numChanges) {
+	return std::max<size_t>(8, (numChanges * (sizeof(uint32_t) + sizeof(uint8_t)) + 7) / 8 * 8);
+}
+
+GenerationHistory::GenerationHistory(const NeighborTable & neighborTable, size_t capacity) :
+		m_neighborTable(neighborTable), m_keyframeSize(0), m_buffer(capacity), m_generation(0) {
+}
+
+GenerationHistory::~GenerationHistory(void) {
+}
+
+void GenerationHistory::Clear(const LifeSimulation & simulation, uint64_t generation) {
+	m_entries.clear();
+	m_editIndices.clear();
+	m_editToggles.clear();
+	m_generation = generation;
+
+	m_keyframeSize = 0;
+	for (unsigned int f = 0; f < BoardSides::NUM_SIDES; ++f)
+		m_keyframeSize += size_t(NUM_PLANES) * m_neighborTable.GetFaceSize(f).x * simulation.GetRowWords(f) * sizeof(uint64_t);
+
+	AddKeyframe(simulation, generation);
+}
+
+void GenerationHistory::AddEdit(unsigned int index, uint8_t toggle) {
+	if (m_entries.empty() || !toggle)
+		return;
+
+	m_editIndices.push_back(index);
+	m_editToggles.push_back(toggle);
+}
+
+void GenerationHistory::AddGeneration(const LifeSimulation & simulation, const std::vector<uint32_t> & indices,
+		const std::vector<uint8_t> & states) {
+	FlushEdits(); //edits belong to the generation they were made on
+	++m_generation;
+
+	if (!m_entries.empty()) {
+		m_changeToggles.resize(states.size());
+		for (unsigned int i = 0; i < indices.size(); ++i)
+			m_changeToggles[i] = states[i] ^ simulation.GetLastState(indices[i]);
+		AddDelta(HISTORY_GENERATION, m_generation, indices, m_changeToggles);
+	}
+
+	//history starts over from here if everything had to be dropped to make room
+	if (m_generation % HISTORY_KEYFRAME_INTERVAL == 0 || m_entries.empty())
+		AddKeyframe(simulation, m_generation);
+}
+
+//current = S'(g): generation g with edits made after it. Last = S'(g - 1)
+//stepping back makes S'(g - 1) current, which is the last generation already, and rebuilds S'(g - 2) from it
+//S'(g - 2) = S'(g - 1) ^ edits after g - 1 ^ delta of g - 1, so only entries back to the delta before are needed
+bool GenerationHistory::StepBack(LifeSimulation & simulation) {
+	FlushEdits();
+
+	//undo edits & drop keyframe of current generation - the simulation holds the same
+	while (!m_entries.empty() && m_entries.back().m_kind != HISTORY_GENERATION) {
+		if (m_entries.size() == 1) //keyframe of oldest generation kept
+			return false;
+
+		if (m_entries.back().m_kind == HISTORY_EDIT)
+			ToggleEntry(simulation, m_entries.back());
+		m_entries.pop_back();
+	}
+	if (m_entries.size() < 2)
+		return false;
+
+	//flips that turn S'(g - 1) into S'(g - 2)
+	m_changeIndices.clear();
+	m_changeToggles.clear();
+	std::deque<HistoryEntry>::const_reverse_iterator entry = m_entries.rbegin() + 1;
+	for (; entry != m_entries.rend() && entry->m_kind == HISTORY_EDIT; ++entry) {
+		const uint32_t * indices = reinterpret_cast<const uint32_t *>(m_buffer.data() + entry->m_offset);
+		const uint8_t * toggles = reinterpret_cast<const uint8_t *>(indices + entry->m_numChanges);
+		m_changeIndices.insert(m_changeIndices.end(), indices, indices + entry->m_numChanges);
+		m_changeToggles.insert(m_changeToggles.end(), toggles, toggles + entry->m_numChanges);
+	}
+
+	if (entry->m_kind == HISTORY_GENERATION) {
+		const uint32_t * indices = reinterpret_cast<const uint32_t *>(m_buffer.data() + entry->m_offset);
+		const uint8_t * toggles = reinterpret_cast<const uint8_t *>(indices + entry->m_numChanges);
+		m_changeIndices.insert(m_changeIndices.end(), indices, indices + entry->m_numChanges);
+		m_changeToggles.insert(m_changeToggles.end(), toggles, toggles + entry->m_numChanges);
+		simulation.StepBack(&m_changeIndices[0], &m_changeToggles[0], m_changeIndices.size());
+	} else {
+		//generation before is a keyframe holding S(g - 1) & S'(g - 2) - put the edits made after it back in
+		RestoreKeyframe(simulation, *entry);
+		for (std::deque<HistoryEntry>::const_iterator edit = entry.base(); edit != m_entries.end() - 1; ++edit)
+			ToggleEntry(simulation, *edit);
+	}
+
+	m_entries.pop_back();
+	m_generation = m_entries.back().m_generation;
+	return true;
+}
+
+void GenerationHistory::RewindTo(LifeSimulation & simulation, uint64_t generation) {
+	FlushEdits();
+	if (m_entries.empty())
+		return;
+	generation = std::max(generation, GetOldestGeneration());
+
+	//newest keyframe at or after generation, & bytes of deltas that would be stepped through without it
+	std::deque<HistoryEntry>::iterator keyframe = m_entries.end();
+	size_t deltaBytes = 0;
+	for (std::deque<HistoryEntry>::iterator entry = m_entries.end(); entry != m_entries.begin();) {
+		--entry;
+		if (entry->m_generation < generation)
+			break;
+		if (entry->m_kind == HISTORY_KEYFRAME) {
+			keyframe = entry;
+			break;
+		}
+		deltaBytes += entry->m_size;
+	}
+
+	if (keyframe != m_entries.end() && keyframe + 1 != m_entries.end() && deltaBytes > m_keyframeSize) {
+		//keyframe is taken before edits are made on its generation, so those have to be put back in
+		RestoreKeyframe(simulation, *keyframe);
+		std::deque<HistoryEntry>::iterator entry = keyframe + 1;
+		for (; entry != m_entries.end() && entry->m_kind == HISTORY_EDIT; ++entry)
+			ToggleEntry(simulation, *entry);
+
+		m_generation = keyframe->m_generation;
+		m_entries.erase(entry, m_entries.end());
+	}
+
+	while (m_generation > generation && StepBack(simulation))
+		;
+}
+
+uint64_t GenerationHistory::GetGeneration(void) const {
+	return m_generation;
+}
+
+uint64_t GenerationHistory::GetOldestGeneration(void) const {
+	return (m_entries.empty()) ? m_generation : m_entries.front().m_generation;
+}
+
+size_t GenerationHistory::GetSize(void) const {
+	if (m_entries.empty())
+		return 0;
+
+	size_t begin = m_entries.front().m_offset, end = m_entries.back().m_offset + m_entries.back().m_size;
+	return (end > begin) ? end - begin : m_buffer.size() - begin + end;
+}
+
+//entries are laid out one after the other & wrap around to the start of the buffer when the end is reached
+//the entries right after the newest one are the oldest, so making room only ever drops the oldest entries
+uint8_t * GenerationHistory::Allocate(size_t size) {
+	if (m_buffer.empty() || size > m_buffer.size())
+		return nullptr;
+
+	size_t offset = (m_entries.empty()) ? 0 : m_entries.back().m_offset + m_entries.back().m_size;
+	if (offset + size > m_buffer.size()) {
+		//entries after the end of the newest one are older than anything at the start
+		while (!m_entries.empty() && m_entries.front().m_offset >= offset)
+			m_entries.pop_front();
+		offset = 0;
+	}
+	while (!m_entries.empty() && m_entries.front().m_offset >= offset && m_entries.front().m_offset < offset + size)
+		m_entries.pop_front();
+
+	return m_buffer.data() + offset;
+}
+
+void GenerationHistory::AddDelta(EntryKind kind, uint64_t generation, const std::vector<uint32_t> & indices,
+		const std::vector<uint8_t> & toggles) {
+	size_t size = GetDeltaSize(indices.size());
+	uint8_t * data = Allocate(size);
+	if (!data) { //too big for the whole history - nothing before can be rewound to anymore
+		m_entries.clear();
+		return;
+	}
+
+	std::memcpy(data, indices.data(), indices.size() * sizeof(uint32_t));
+	std::memcpy(data + indices.size() * sizeof(uint32_t), toggles.data(), toggles.size() * sizeof(uint8_t));
+	m_entries.push_back( { size_t(data - m_buffer.data()), size, kind, (unsigned int) indices.size(), generation });
+	DropOldDeltas();
+}
+
+void GenerationHistory::AddKeyframe(const LifeSimulation & simulation, uint64_t generation) {
+	uint8_t * data = Allocate(m_keyframeSize);
+	if (!data) {
+		m_entries.clear();
+		return;
+	}
+
+	m_entries.push_back( { size_t(data - m_buffer.data()), m_keyframeSize, HISTORY_KEYFRAME, 0, generation });
+	for (unsigned int f = 0; f < BoardSides::NUM_SIDES; ++f) {
+		size_t rowSize = simulation.GetRowWords(f) * sizeof(uint64_t);
+		for (unsigned int p = 0; p < NUM_PLANES; ++p) {
+			for (unsigned int r = 0; r < m_neighborTable.GetFaceSize(f).x; ++r) {
+				std::memcpy(data, simulation.GetRow(f, r, static_cast<LifePlane>(p)), rowSize);
+				data += rowSize;
+			}
+		}
+	}
+	DropOldDeltas();
+}
+
+void GenerationHistory::RestoreKeyframe(LifeSimulation & simulation, const HistoryEntry & entry) const {
+	const uint64_t * words = reinterpret_cast<const uint64_t *>(m_buffer.data() + entry.m_offset);
+	for (unsigned int f = 0; f < BoardSides::NUM_SIDES; ++f) {
+		for (unsigned int p = 0; p < NUM_PLANES; ++p) {
+			for (unsigned int r = 0; r < m_neighborTable.GetFaceSize(f).x; ++r) {
+				simulation.SetRow(f, r, static_cast<LifePlane>(p), words);
+				words += simulation.GetRowWords(f);
+			}
+		}
+	}
+}
+
+void GenerationHistory::ToggleEntry(LifeSimulation & simulation, const HistoryEntry & entry) const {
+	const uint32_t * indices = reinterpret_cast<const uint32_t *>(m_buffer.data() + entry.m_offset);
+	simulation.ToggleElements(indices, reinterpret_cast<const uint8_t *>(indices + entry.m_numChanges), entry.m_numChanges);
+}
+
+void GenerationHistory::FlushEdits(void) {
+	if (m_editIndices.empty())
+		return;
+
+	AddDelta(HISTORY_EDIT, m_generation, m_editIndices, m_editToggles);
+	m_editIndices.clear();
+	m_editToggles.clear();
+}
+
+void GenerationHistory::DropOldDeltas(void) {
+	while (!m_entries.empty() && m_entries.front().m_kind != HISTORY_KEYFRAME)
+		m_entries.pop_front();
+}
@@ -1,10 +1,9 @@
 #include "graphics.h"
-
-#include <unordered_set>
+#include "trace.h"
 
 Graphics::Graphics(const glm::uvec2 & windowSize, const glm::vec3 & eyePos, const glm::vec3 & eyeFocus, const GameInfo & game) :
-		m_camera(windowSize.x, windowSize.y, eyePos, eyeFocus), m_yaw(0.f), m_pitch(0.f), m_board(nullptr), m_generation(0), m_isMultiplayer(false), m_screenSize(
-				windowSize) {
+		m_camera(windowSize.x, windowSize.y, eyePos, eyeFocus), m_yaw(0.f), m_pitch(0.f), m_board(nullptr), m_generation(0), m_isMultiplayer(false), m_isAIOpponent(false), m_screenSize(
+				windowSize), m_generationRequested(false), m_generationShutdown(false) {
 
 	// Used for the linux OS
 #if !defined(__APPLE__) && !defined(MACOSX)
@@ -38,8 +37,11 @@ Graphics::Graphics(const glm::uvec2 & windowSize, const glm::vec3 & eyePos, cons
 
 	m_calculatingGeneration.store(false);
 	m_isAutoplaying = false;
-	m_autoplayInterval = 500; //half second interval
+	m_autoplayInterval = std::chrono::steady_clock::duration::zero();
+	if (game.m_autoplayRate > 0)
+		m_autoplayInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.f / game.m_autoplayRate));
 	m_board = new Board(game); //load board
+	m_generationThread = std::thread(&Graphics::GenerationWorker, this);
 
 	srand(time(nullptr));
 
@@ -47,11 +49,16 @@ Graphics::Graphics(const glm::uvec2 & windowSize, const glm::vec3 & eyePos, cons
 }
 
 Graphics::~Graphics(void) {
-	if (m_calculatingGeneration.load()) {
-		m_generationThread->join();
-	} else if (m_isAutoplaying.load()) {
-		StopAutoplay();
+	StopAutoplay();
+	WaitForGeneration();
+
+	{
+		std::lock_guard<std::mutex> lock(m_generationMutex);
+		m_generationShutdown = true;
 	}
+	m_generationCondition.notify_all();
+	m_generationThread.join();
+
 	delete m_board;
 }
 
@@ -65,7 +72,7 @@ void Graphics::UseShaderSet(const std::string & setName) {
 	UpdateCameraBindings();
 }
 
-void Graphics::Update(unsigned int dt) {
+void Graphics::Update(float dt) {
 	m_board->Update();
 	m_board->UpdateSpotlightLoc(GetEyeFocus());
 }
@@ -207,7 +214,7 @@ void Graphics::ChangeSpecularLight(const glm::vec3 & change) {
 void Graphics::LeftClick(const glm::vec2 & mousePosition) {
 	glm::uvec3 elementClicked;
 	try {
-		elementClicked = m_board->GetGameElementByPosition(GetPositionUnder(mousePosition));
+		elementClicked = GetElementUnder(mousePosition);
 	} catch (const std::string & e) {
 #ifdef DEBUG
 		printf("\n%s\n", e.c_str());
@@ -248,93 +255,55 @@ void Graphics::LeftClick(const glm::vec2 & mousePosition) {
 	}
 }
 
-struct PositionComparator {
-public:
-
-	inline bool operator()(const std::pair<glm::uvec3, ObjType> & x1, const std::pair<glm::uvec3, ObjType> & x2) const {
-		return x1.first == x2.first;
-	}
-};
-
-struct PositionHasher {
+// Updates the board one generation, according to Conway's rules
 
-	inline std::size_t operator()(const std::pair<glm::uvec3, ObjType> & x) const {
-		return (std::hash<unsigned int>()(x.first.x * 100 + x.first.y * 100 + x.first.z * 100));
+void Graphics::MoveForwardGeneration(void) {
+	{
+		std::lock_guard<std::mutex> lock(m_generationMutex);
+		m_calculatingGeneration.store(true);
+		m_generationRequested = true;
 	}
-};
+	m_generationCondition.notify_all();
+}
 
-// Updates the board one generation, according to Conway's rules
+void Graphics::GenerationWorker(void) {
+	TRACE_THREAD_NAME("Generation");
+	std::unique_lock<std::mutex> lock(m_generationMutex);
+	while (true) {
+		m_generationCondition.wait(lock, [this] {return m_generationRequested || m_generationShutdown;});
+		if (m_generationShutdown)
+			return;
+		m_generationRequested = false;
 
-void Graphics::MoveForwardGeneration(void) {
-	m_calculatingGeneration.store(true);
-#ifdef DEBUG
-	printf("launching thread");
-#endif
-	m_generationThread = new std::thread([this] {
-		glm::uvec3 tempElement(0, 0, 0);
-		std::unordered_set<std::pair<glm::uvec3, ObjType>, PositionHasher, PositionComparator> updates; //keep track of updated in hash table - effecient
-
-			do { //go through all the elements
-				ObjType tempElementType = m_board->GetGameElementType(tempElement);
-
-				//update marked ones
-				if (tempElementType == P1_DEAD_FUTURE || tempElementType == P1_DEAD_MARKED || tempElementType == P2_DEAD_FUTURE
-						|| tempElementType == P2_DEAD_MARKED) {
-					this->m_board->SetGameElementType(tempElement);
-					tempElementType = DEAD;
-				} else if (tempElementType == P1_ALIVE_FUTURE || tempElementType == P1_ALIVE_MARKED) {
-					this->m_board->SetGameElementType(tempElement, P1_ALIVE);
-					tempElementType = P1_ALIVE;
-				} else if (tempElementType == P2_ALIVE_FUTURE || tempElementType == P2_ALIVE_MARKED) {
-					this->m_board->SetGameElementType(tempElement, P2_ALIVE);
-					tempElementType = P2_ALIVE;
-				}
-
-				int aliveNeighbors = 0, blueNeighbors = 0, redNeighbors = 0;
-				bool isAlive = false;
-				std::vector < glm::uvec3 > neighbors = this->m_board->GetGameElementNeighbors(tempElement);
-
-				if (tempElementType == P1_ALIVE || tempElementType == P2_ALIVE)
-				isAlive = true;
-
-				//get count of neighbors
-				for (const glm::uvec3 & e : neighbors) {
-					ObjType typeTemp = m_board->GetGameElementType(e);
-					if (typeTemp == P1_ALIVE || typeTemp == P1_ALIVE_FUTURE || typeTemp == P1_ALIVE_MARKED) {
-						++aliveNeighbors;
-						++blueNeighbors;
-					} else if (typeTemp == P2_ALIVE || typeTemp == P2_ALIVE_FUTURE || typeTemp == P2_ALIVE_MARKED) {
-						++aliveNeighbors;
-						++redNeighbors;
-					}
-				}
-
-				if (isAlive && (aliveNeighbors < 2 || aliveNeighbors > 3)) { //rule 1 & 3 - death by under & over population
-					(tempElementType == P1_ALIVE) ?
-					updates.insert(std::pair<glm::uvec3, ObjType>(tempElement, P1_DEAD_FUTURE)) :
-					updates.insert(std::pair<glm::uvec3, ObjType>(tempElement, P2_DEAD_FUTURE));
-				} else if (!isAlive && aliveNeighbors == 3) { //rule 4 - growth
-					(blueNeighbors > redNeighbors) ?
-					updates.insert(std::pair<glm::uvec3, ObjType>(tempElement, P1_ALIVE_FUTURE)) :
-					updates.insert(std::pair<glm::uvec3, ObjType>(tempElement, P2_ALIVE_FUTURE));
-				}
-				tempElement = this->m_board->GetNextGameElement(tempElement); //go to next element
-			}while (tempElement != glm::uvec3(0, 0, 0)); //check if all have been iterated through
-
-			//update elements
-			for (const std::pair<glm::uvec3, ObjType> & x : updates) {
-				this->m_board->SetGameElementType(x.first, x.second);
-			}
-
-			this->m_generation = this->m_generation + 1;
-
-			printf("\nGeneration %i done!\n", m_generation);
+		lock.unlock();
 #ifdef DEBUG
-			printf("Exiting thread\n");
+		printf("computing generation on worker thread\n");
 #endif
+		if (m_board->StepGeneration()) {
+			++m_generation;
+			TRACE_COUNTER("Generation", m_generation);
+			if (m_board->GetPeriod())
+				printf("\nGeneration %i done! Board repeats every %u generation(s)\n", m_generation, m_board->GetPeriod());
+			else
+				printf("\nGeneration %i done!\n", m_generation);
+		}
+		lock.lock();
+
+		//notified even if another generation is requested - a waiting main thread has to pick this one up for the next to start
+		if (!m_generationRequested)
 			m_calculatingGeneration.store(false);
-		});
-	m_generationThread->detach();
+		m_generationCondition.notify_all();
+	}
+}
+
+//worker may be waiting for the renderer to pick up the last generation, so every generation published while waiting is picked up
+void Graphics::WaitForGeneration(void) {
+	std::unique_lock<std::mutex> lock(m_generationMutex);
+	m_board->PickUpGeneration();
+	while (m_calculatingGeneration.load()) {
+		m_generationCondition.wait(lock, [this] {return !m_calculatingGeneration.load() || m_board->HasNewGeneration();});
+		m_board->PickUpGeneration();
+	}
 }
 
 bool Graphics::IsGenerating(void) const {
@@ -350,34 +319,183 @@ bool Graphics::IsAutoplaying(void) const {
 }
 
 void Graphics::StartAutoplay(void) {
-	m_isAutoplaying = true;
-	m_autoplayThread = new std::thread([this]() {
-		std::chrono::high_resolution_clock::time_point t1, t2;
-		float duration;
-		while (this->m_isAutoplaying.load()) {
-			t1 = std::chrono::high_resolution_clock::now();
-			this->MoveForwardGeneration();
-			while (m_calculatingGeneration.load());
-			t2 = std::chrono::high_resolution_clock::now();
-			duration = std::chrono::duration_cast < std::chrono::milliseconds > (t2 - t1).count();
-			if (duration < m_autoplayInterval)
-			std::this_thread::sleep_for(std::chrono::milliseconds((int) (this->m_autoplayInterval - duration)));
-		}
-	});
-	m_autoplayThread->detach();
+	if (m_isAutoplaying.load())
+		return;
+
+	if (m_autoplayThread.joinable()) //autoplay paused itself
+		m_autoplayThread.join();
+
+	m_isAutoplaying.store(true);
+	m_autoplayThread = std::thread(&Graphics::AutoplayWorker, this);
 }
 
 void Graphics::StopAutoplay(void) {
-	m_isAutoplaying.store(false);
-	while (m_calculatingGeneration)
-		;
+	if (!m_autoplayThread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_generationMutex);
+		m_isAutoplaying.store(false);
+	}
+	m_generationCondition.notify_all();
+	m_autoplayThread.join();
+
+	WaitForGeneration();
+}
+
+//generations are started on a fixed schedule so rate does not drift with how long each one takes
+//if a generation takes longer than the interval, the next one starts right away and the schedule restarts from there
+//autoplay pauses itself once the board stops changing or repeats - unless it was already repeating when autoplay was started
+void Graphics::AutoplayWorker(void) {
+	TRACE_THREAD_NAME("Autoplay");
+	std::unique_lock<std::mutex> lock(m_generationMutex);
+	std::chrono::steady_clock::time_point nextGeneration = std::chrono::steady_clock::now();
+	bool wasRepeating = m_board->GetPeriod();
+
+	while (m_isAutoplaying.load()) {
+		m_calculatingGeneration.store(true);
+		m_generationRequested = true;
+		m_generationCondition.notify_all();
+
+		m_generationCondition.wait(lock, [this] {return !m_calculatingGeneration.load() || !m_isAutoplaying.load();});
+
+		unsigned int period = m_board->GetPeriod();
+		if (period && !wasRepeating && m_isAutoplaying.load()) {
+			(period == 1) ? printf("\nBoard stopped changing - autoplay paused\n") :
+					printf("\nBoard repeats every %u generations - autoplay paused\n", period);
+			m_isAutoplaying.store(false);
+			return;
+		}
+		wasRepeating = wasRepeating && period;
+
+		nextGeneration += m_autoplayInterval;
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (nextGeneration < now)
+			nextGeneration = now;
+		else
+			m_generationCondition.wait_until(lock, nextGeneration, [this] {return !m_isAutoplaying.load();});
+	}
+}
+
+//autoplay would start the next generation right after the wait, so it is stopped while saving & picks up again after
+void Graphics::SaveSnapshot(void) {
+	bool autoplaying = m_isAutoplaying.load();
+	if (autoplaying)
+		StopAutoplay();
+	WaitForGeneration(); //board can only be read while no generation is being computed
+
+	try {
+		m_board->SaveSnapshot(SNAPSHOT_FILE, m_generation);
+		printf("\nSaved generation %i to %s\n", m_generation, SNAPSHOT_FILE);
+	} catch (std::string & err) {
+		printf("\n%s\n", err.c_str());
+	}
+
+	if (autoplaying)
+		StartAutoplay();
+}
+
+void Graphics::LoadSnapshot(void) {
+	if (m_isAutoplaying.load())
+		StopAutoplay();
+	WaitForGeneration(); //board can only be changed while no generation is being computed
+
+	try {
+		m_generation = m_board->LoadSnapshot(SNAPSHOT_FILE);
+		m_board->ClearPopulationHistory();
+		printf("\nLoaded generation %i from %s\n", m_generation, SNAPSHOT_FILE);
+	} catch (std::string & err) {
+		printf("\n%s\n", err.c_str());
+	}
+}
+
+//log is started & stopped between generations - autoplay is stopped meanwhile & picks up again after
+void Graphics::ToggleRecording(void) {
+	bool autoplaying = m_isAutoplaying.load();
+	if (autoplaying)
+		StopAutoplay();
+	WaitForGeneration(); //log has to start between generations
+
+	if (m_board->IsRecording()) {
+		m_board->StopRecording();
+		printf("\nStopped recording to %s\n", GENERATION_LOG_FILE);
+	} else {
+		try {
+			m_board->StartRecording(GENERATION_LOG_FILE, m_generation);
+			printf("\nRecording every generation to %s\n", GENERATION_LOG_FILE);
+		} catch (std::string & err) {
+			printf("\n%s\n", err.c_str());
+		}
+	}
+
+	if (autoplaying)
+		StartAutoplay();
+}
+
+void Graphics::ToggleReplay(void) {
+	if (m_isAutoplaying.load())
+		StopAutoplay();
+	WaitForGeneration(); //board can only be changed while no generation is being computed
+
+	if (m_board->IsReplaying()) {
+		m_board->StopReplay();
+		printf("\nStopped replay - generations are simulated again\n");
+		return;
+	}
+
+	try {
+		m_generation = m_board->StartReplay(GENERATION_LOG_FILE);
+		m_board->ClearPopulationHistory();
+		printf("\nReplaying %s from generation %i - step or autoplay to play it back\n", GENERATION_LOG_FILE, m_generation);
+	} catch (std::string & err) {
+		printf("\n%s\n", err.c_str());
+	}
+}
+
+void Graphics::Rewind(unsigned int generations) {
+	if (m_isAutoplaying.load())
+		StopAutoplay();
+	WaitForGeneration(); //board can only be changed while no generation is being computed
+
+	if (m_board->IsRecording())
+		printf("\nStopped recording to %s - rewinding can not be recorded\n", GENERATION_LOG_FILE);
+	if (m_board->IsReplaying())
+		printf("\nStopped replay - generations are simulated again\n");
+
+	int target = std::max(0, m_generation - int(generations));
+	m_generation = m_board->RewindTo(target);
+	printf("\nRewound to generation %i (oldest kept: %llu)\n", m_generation, (unsigned long long) m_board->GetOldestGeneration());
+}
+
+void Graphics::ToggleAIOpponent(void) {
+	m_isAIOpponent = !m_isAIOpponent;
+	(m_isAIOpponent) ? printf("\nPlayer 2 (Red) is now played by the computer from its next turn\n") : printf("\nPlayer 2 (Red) is now played by a person\n");
+}
+
+void Graphics::PlayAIMove(void) {
+	WaitForGeneration(); //board can only be changed while no generation is being computed
+
+	AIMove move = m_board->FindAIMove(true);
+	if (!move.m_numMarks) {
+		printf("\nPlayer 2 (Red) has no move to make\n");
+		return;
+	}
+
+	for (unsigned int i = 0; i < move.m_numMarks; ++i)
+		m_board->SetGameElementType(move.m_marks[i].m_element, move.m_marks[i].m_type);
+	printf("\nPlayer 2 (Red) %s (scored %u moves, lead after lookahead: %i)\n",
+			(move.m_numMarks == 1) ? "marked 1 of your cells for death" : "marked 2 of its cells for death & 1 dead cell for life",
+			m_board->GetAIMovesScored(), move.m_score);
 }
 
 //Changes between player 1 and player 2
 
 void Graphics::ChangePlayer(void) {
 	if (m_isMultiplayer) {
-		if (m_playerTurnFlag) { //move to player 2 turn
+		if (m_playerTurnFlag && m_isAIOpponent) { //computer plays player 2 turn right away
+			PlayAIMove();
+			MoveForwardGeneration();
+		} else if (m_playerTurnFlag) { //move to player 2 turn
 			m_playerTurnFlag = false;
 		} else { //go to next generation and then back to player 1 turn
 			MoveForwardGeneration();
@@ -396,6 +514,10 @@ void Graphics::ChangePlayer(void) {
 }
 
 void Graphics::Reset(void) {
+	if (m_isAutoplaying.load())
+		StopAutoplay();
+	WaitForGeneration(); //board can only be changed while no generation is being computed
+
 	printf("\nResetting everything!\n");
 	glm::uvec3 tempElement(0, 0, 0);
 	do { //go through all the elements
@@ -403,6 +525,8 @@ void Graphics::Reset(void) {
 		tempElement = m_board->GetNextGameElement(tempElement); //go to next element
 	} while (tempElement != glm::uvec3(0, 0, 0)); //check if all have been iterated through
 	m_generation = 0;
+	m_board->ClearPopulationHistory();
+	m_board->ClearHistory(m_generation);
 	m_isMultiplayer = false;
 	printf("\nYou are now in SinglePlayer mode!\n");
 }
@@ -414,6 +538,8 @@ void Graphics::ChangeGamemode(void) {
 		m_isMultiplayer = false;
 		printf("\nYou are now in SinglePlayer mode! You can press enter for auto simulation!\n");
 	} else { //switch to multiplayer
+		WaitForGeneration(); //board can only be changed while no generation is being computed
+
 		glm::uvec3 tempElement(0, 0, 0);
 		do { //go through all the elements
 			int random = std::rand() % 10; //number between 0-9
@@ -431,6 +557,8 @@ void Graphics::ChangeGamemode(void) {
 
 		printf("\nYou are now in Multiplayer mode! Blocks have been randomly initailized!\n");
 		m_generation = 0;
+		m_board->ClearPopulationHistory();
+		m_board->ClearHistory(m_generation);
 		MoveForwardGeneration();
 		printf("\nIt is now Player 1 (Blue) turn\n");
 		printf("mark 2 of your cells for death & 1 dead cell for life OR 1 opponent cell for death\n");
@@ -464,9 +592,9 @@ void Graphics::UpdateCameraBindings(void) {
 	m_board->UpdateCameraBindings(m_camera.GetView(), m_camera.GetProjection(), m_camera.GetEyePos());
 }
 
-//raycast and find position mouse is pointing at
+//raycast and find game element mouse is pointing at
 
-glm::vec3 Graphics::GetPositionUnder(const glm::vec2 & mousePosition) {
+glm::uvec3 Graphics::GetElementUnder(const glm::vec2 & mousePosition) {
 	float mouseScreenX = (2.0f * mousePosition.x) / m_screenSize.x - 1.0f;
 	float mouseScreenY = 1.0f - (2.0f * mousePosition.y) / m_screenSize.y;
 	glm::vec4 mouseRayStart(mouseScreenX, mouseScreenY, -1.0f, 1.0f);
@@ -487,28 +615,6 @@ glm::vec3 Graphics::GetPositionUnder(const glm::vec2 & mousePosition) {
 
 	glm::vec3 worldRayDirection(worldRayEnd - worldRayStart);
 	worldRayDirection = glm::normalize(worldRayDirection);
-	glm::vec3 worldRayMax = glm::vec3(worldRayStart.x, worldRayStart.y, worldRayStart.z) + worldRayDirection * 1000.0f;
-
-	btVector3 start, end;
-	start = btVector3(worldRayStart.x, worldRayStart.y, worldRayStart.z);
-	end = btVector3(worldRayMax.x, worldRayMax.y, worldRayMax.z);
-
-	//get the raycast callback ready
-	btCollisionWorld::ClosestRayResultCallback closestResults(start, end);
-	closestResults.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
-
-	m_board->GetBulletWorld()->rayTest(start, end, closestResults);
 
-	//if it hit, grab the position of the collider, otherwise throw not found error
-	if (closestResults.hasHit()) {
-		btVector3 hitResults = closestResults.m_collisionObject->getWorldTransform().getOrigin();
-		glm::vec3 cubePosition = glm::vec3(hitResults.x(), hitResults.y(), hitResults.z()); //get position
-
-#ifdef DEBUG
-		printf("\nHit found for |%s|:|%s|\n", glm::to_string(mousePosition).c_str(), glm::to_string(cubePosition).c_str());
-#endif
-		return cubePosition;
-	} else {
-		throw std::string("No hit found for: " + glm::to_string(mousePosition));
-	}
+	return m_board->GetGameElementByRay(glm::vec3(worldRayStart), worldRayDirection);
 }
@@ -0,0 +1,166 @@
+#include "lifeAI.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+
+LifeAI::LifeAI(const NeighborTable & neighborTable, unsigned int numThreads, unsigned int lookahead, unsigned int timeBudget) :
+		m_neighborTable(neighborTable), m_lookahead(lookahead), m_timeBudget(timeBudget), m_threadPool(numThreads), m_movesScored(0) {
+	//every thread steps its copy by itself - moves are what is run in parallel
+	for (unsigned int i = 0; i < m_threadPool.GetNumThreads(); ++i)
+		m_scratch.emplace_back(new LifeSimulation(neighborTable, 1));
+}
+
+LifeAI::~LifeAI(void) {
+}
+
+AIMove LifeAI::FindMove(const LifeSimulation & simulation, const ObjType * types, bool player2) {
+	TRACE_SCOPE("Find AI move");
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_timeBudget);
+
+	FindCandidates(simulation, types, player2);
+	m_scores.resize(m_candidates.size());
+	m_movesScored = 0;
+
+	//most promising moves are scored first, so running out of time only skips the least promising ones. First batch is always scored
+	const unsigned int batchSize = m_threadPool.GetNumThreads() * AI_BATCH_PER_THREAD;
+	while (m_movesScored < m_candidates.size() && (!m_movesScored || std::chrono::steady_clock::now() < deadline)) {
+		const unsigned int first = m_movesScored, count = std::min<unsigned int>(batchSize, m_candidates.size() - first);
+		m_threadPool.ParallelFor(count, [this, &simulation, player2, first](unsigned int i, unsigned int thread) {
+			m_scores[first + i] = ScoreMove(simulation, m_candidates[first + i], player2, *m_scratch[thread]);
+		});
+		m_movesScored += count;
+	}
+	TRACE_COUNTER("AI moves scored", m_movesScored);
+
+	AIMove best;
+	best.m_numMarks = 0;
+	best.m_score = 0;
+	for (unsigned int i = 0; i < m_movesScored; ++i) {
+		if (!best.m_numMarks || m_scores[i] > best.m_score) { //ties go to the move that looked more promising
+			best = m_candidates[i];
+			best.m_score = m_scores[i];
+		}
+	}
+	return best;
+}
+
+unsigned int LifeAI::GetMovesScored(void) const {
+	return m_movesScored;
+}
+
+//legal moves are the same as for a player clicking (see Graphics::LeftClick) - only unmarked elements can be marked
+//every opponent element can be killed, but giving up 2 own elements & placing 1 is only tried with the elements most likely to matter
+void LifeAI::FindCandidates(const LifeSimulation & simulation, const ObjType * types, bool player2) {
+	const ObjType own = (player2) ? P2_ALIVE : P1_ALIVE, enemy = (player2) ? P1_ALIVE : P2_ALIVE;
+	const ObjType killMark = (player2) ? P2_DEAD_MARKED : P1_DEAD_MARKED, birthMark = (player2) ? P2_ALIVE_MARKED : P1_ALIVE_MARKED;
+	const unsigned int numElements = m_neighborTable.GetNumElements();
+	const LifeRule & rule = simulation.GetRule();
+
+	m_kills.clear();
+	m_trades.clear();
+	m_candidates.clear();
+
+	//opponent elements that would survive the next generation first - killing one that dies anyway does nothing
+	m_ranking.clear();
+	for (unsigned int i = 0; i < numElements; ++i) {
+		if (types[i] != enemy)
+			continue;
+		unsigned int neighbors = CountLivingNeighbors(simulation, i);
+		m_ranking.push_back(std::make_pair(rule.m_table[1][neighbors], i));
+	}
+	std::stable_sort(m_ranking.begin(), m_ranking.end(), [](const std::pair<int, unsigned int> & a, const std::pair<int, unsigned int> & b) {
+		return a.first > b.first;
+	});
+	for (const std::pair<int, unsigned int> & kill : m_ranking) {
+		AIMove move;
+		move.m_marks[0] = {kill.second, killMark};
+		move.m_numMarks = 1;
+		move.m_score = 0;
+		m_kills.push_back(move);
+	}
+
+	//own elements that die anyway cost nothing to give up
+	m_ranking.clear();
+	for (unsigned int i = 0; i < numElements; ++i) {
+		if (types[i] != own)
+			continue;
+		unsigned int neighbors = CountLivingNeighbors(simulation, i);
+		m_ranking.push_back(std::make_pair(!rule.m_table[1][neighbors], i));
+	}
+	std::stable_sort(m_ranking.begin(), m_ranking.end(), [](const std::pair<int, unsigned int> & a, const std::pair<int, unsigned int> & b) {
+		return a.first > b.first;
+	});
+	unsigned int sacrifices[AI_SACRIFICE_CANDIDATES];
+	const unsigned int numSacrifices = std::min<unsigned int>(AI_SACRIFICE_CANDIDATES, m_ranking.size()); //less than 2 = no trades
+	for (unsigned int i = 0; i < numSacrifices; ++i)
+		sacrifices[i] = m_ranking[i].second;
+
+	//dead elements next to own elements - ones that would survive & have the most own neighbors first
+	m_ranking.clear();
+	for (unsigned int i = 0; i < numElements; ++i) {
+		if (types[i] != own)
+			continue;
+		for (const uint32_t * n = m_neighborTable.NeighborsBegin(i); n != m_neighborTable.NeighborsEnd(i); ++n)
+			if (types[*n] == DEAD)
+				m_ranking.push_back(std::make_pair(0, *n));
+	}
+	std::sort(m_ranking.begin(), m_ranking.end(), [](const std::pair<int, unsigned int> & a, const std::pair<int, unsigned int> & b) {
+		return a.second < b.second;
+	});
+	m_ranking.erase(std::unique(m_ranking.begin(), m_ranking.end(), [](const std::pair<int, unsigned int> & a, const std::pair<int, unsigned int> & b) {
+		return a.second == b.second;
+	}), m_ranking.end());
+	for (std::pair<int, unsigned int> & birth : m_ranking) {
+		unsigned int neighbors = 0, ownNeighbors = 0;
+		for (const uint32_t * n = m_neighborTable.NeighborsBegin(birth.second); n != m_neighborTable.NeighborsEnd(birth.second); ++n) {
+			neighbors += simulation.IsAlive(*n);
+			ownNeighbors += (types[*n] == own);
+		}
+		birth.first = ((rule.m_table[1][std::min(neighbors, LIFE_RULE_COUNTS - 1u)]) ? 16 : 0) + ownNeighbors;
+	}
+	std::stable_sort(m_ranking.begin(), m_ranking.end(), [](const std::pair<int, unsigned int> & a, const std::pair<int, unsigned int> & b) {
+		return a.first > b.first;
+	});
+	const unsigned int numBirths = std::min<unsigned int>(AI_BIRTH_CANDIDATES, m_ranking.size());
+
+	for (unsigned int b = 0; b < numBirths; ++b) {
+		for (unsigned int s0 = 0; s0 < numSacrifices; ++s0) {
+			for (unsigned int s1 = s0 + 1; s1 < numSacrifices; ++s1) {
+				AIMove move;
+				move.m_marks[0] = {sacrifices[s0], killMark};
+				move.m_marks[1] = {sacrifices[s1], killMark};
+				move.m_marks[2] = {m_ranking[b].second, birthMark};
+				move.m_numMarks = 3;
+				move.m_score = 0;
+				m_trades.push_back(move);
+			}
+		}
+	}
+
+	//kinds of move take turns, so both are scored even with little time
+	for (unsigned int i = 0; i < std::max(m_kills.size(), m_trades.size()); ++i) {
+		if (i < m_kills.size())
+			m_candidates.push_back(m_kills[i]);
+		if (i < m_trades.size())
+			m_candidates.push_back(m_trades[i]);
+	}
+}
+
+unsigned int LifeAI::CountLivingNeighbors(const LifeSimulation & simulation, unsigned int index) const {
+	unsigned int count = 0;
+	for (const uint32_t * n = m_neighborTable.NeighborsBegin(index); n != m_neighborTable.NeighborsEnd(index); ++n)
+		count += simulation.IsAlive(*n);
+	return std::min(count, LIFE_RULE_COUNTS - 1u); //see LIFE_RULE_COUNTS
+}
+
+int LifeAI::ScoreMove(const LifeSimulation & simulation, const AIMove & move, bool player2, LifeSimulation & scratch) const {
+	scratch.CopyFrom(simulation);
+	for (unsigned int i = 0; i < move.m_numMarks; ++i)
+		scratch.SetElement(move.m_marks[i].m_element, move.m_marks[i].m_type);
+	for (unsigned int g = 0; g < m_lookahead; ++g)
+		scratch.Step();
+
+	glm::uvec2 population = scratch.GetPopulation();
+	return (player2) ? int(population.y) - int(population.x) : int(population.x) - int(population.y);
+}
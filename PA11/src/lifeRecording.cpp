@@ -0,0 +1,286 @@
+#include "lifeRecording.h"
+
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//bytes of a record with its changes & padding to 8 bytes
+static size_t GetRecordSize(uint32_t numChanges) {
+	size_t size = sizeof(LogRecord) + size_t(numChanges) * (sizeof(uint32_t) + sizeof(uint8_t));
+	return (size + 7) / 8 * 8;
+}
+
+void WriteSnapshot(const std::string & fileName, const LifeSimulation & simulation, const NeighborTable & neighborTable, uint64_t generation) {
+	std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		throw std::string("Could not open snapshot file for writing: " + fileName);
+
+	SnapshotHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.m_magic, SNAPSHOT_MAGIC, sizeof(header.m_magic));
+	header.m_version = SNAPSHOT_VERSION;
+	header.m_numFaces = BoardSides::NUM_SIDES;
+	for (unsigned int f = 0; f < BoardSides::NUM_SIDES; ++f) {
+		header.m_faceSizes[f][0] = neighborTable.GetFaceSize(f).x;
+		header.m_faceSizes[f][1] = neighborTable.GetFaceSize(f).y;
+	}
+	header.m_generation = generation;
+	header.m_dataOffset = sizeof(header);
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	for (unsigned int f = 0; f < BoardSides::NUM_SIDES; ++f)
+		for (unsigned int p = 0; p < NUM_PLANES; ++p)
+			for (unsigned int r = 0; r < header.m_faceSizes[f][0]; ++r)
+				file.write(reinterpret_cast<const char *>(simulation.GetRow(f, r, static_cast<LifePlane>(p))),
+						simulation.GetRowWords(f) * sizeof(uint64_t));
+
+	if (!file.good())
+		throw std::string("Could not write snapshot file: " + fileName);
+}
+
+uint64_t ReadSnapshot(const std::string & fileName, LifeSimulation & simulation, const NeighborTable & neighborTable) {
+	MappedFile file(fileName);
+	if (file.GetSize() < sizeof(SnapshotHeader))
+		throw std::string("Snapshot file is too small: " + fileName);
+
+	const SnapshotHeader * header = reinterpret_cast<const SnapshotHeader *>(file.GetData());
+	if (std::memcmp(header->m_magic, SNAPSHOT_MAGIC, sizeof(header->m_magic)))
+		throw std::string("Not a snapshot file: " + fileName);
+	if (header->m_version != SNAPSHOT_VERSION)
+		throw std::string("Unsupported snapshot version " + std::to_string(header->m_version) + " in " + fileName);
+	if (header->m_numFaces != BoardSides::NUM_SIDES)
+		throw std::string("Snapshot " + fileName + " has " + std::to_string(header->m_numFaces) + " faces");
+
+	//check everything before changing the simulation, so a bad file leaves the board as it was
+	size_t numWords = 0;
+	for (unsigned int f = 0; f < BoardSides::NUM_SIDES; ++f) {
+		if (glm::uvec2(header->m_faceSizes[f][0], header->m_faceSizes[f][1]) != neighborTable.GetFaceSize(f))
+			throw std::string("Snapshot " + fileName + " was saved from a board with a different size of face " + std::to_string(f));
+		numWords += size_t(NUM_PLANES) * header->m_faceSizes[f][0] * simulation.GetRowWords(f);
+	}
+	if (header->m_dataOffset % 8 || header->m_dataOffset > file.GetSize() || (file.GetSize() - header->m_dataOffset) / 8 < numWords)
+		throw std::string("Snapshot file is cut short: " + fileName);
+
+	const uint64_t * words = reinterpret_cast<const uint64_t *>(file.GetData() + header->m_dataOffset);
+	for (unsigned int f = 0; f < BoardSides::NUM_SIDES; ++f) {
+		for (unsigned int p = 0; p < NUM_PLANES; ++p) {
+			for (unsigned int r = 0; r < header->m_faceSizes[f][0]; ++r) {
+				simulation.SetRow(f, r, static_cast<LifePlane>(p), words);
+				words += simulation.GetRowWords(f);
+			}
+		}
+	}
+
+	return header->m_generation;
+}
+
+MappedFile::MappedFile(const std::string & fileName) :
+		m_data(nullptr), m_size(0) {
+	int file = open(fileName.c_str(), O_RDONLY);
+	if (file < 0)
+		throw std::string("Could not open file: " + fileName);
+
+	struct stat info;
+	if (fstat(file, &info) < 0) {
+		close(file);
+		throw std::string("Could not get size of file: " + fileName);
+	}
+	m_size = info.st_size;
+
+	if (m_size) {
+		void * data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data == MAP_FAILED) {
+			close(file);
+			throw std::string("Could not map file: " + fileName);
+		}
+		m_data = static_cast<const uint8_t *>(data);
+	}
+	close(file); //mapping stays valid
+}
+
+MappedFile::~MappedFile(void) {
+	if (m_data)
+		munmap(const_cast<uint8_t *>(m_data), m_size);
+}
+
+const uint8_t * MappedFile::GetData(void) const {
+	return m_data;
+}
+
+size_t MappedFile::GetSize(void) const {
+	return m_size;
+}
+
+GenerationLog::GenerationLog(const std::string & fileName, const LifeSimulation & simulation, unsigned int numElements, uint64_t generation) :
+		m_file(fileName, std::ios::binary | std::ios::trunc), m_generation(generation) {
+	if (!m_file.is_open())
+		throw std::string("Could not open generation log for writing: " + fileName);
+
+	LogHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.m_magic, GENERATION_LOG_MAGIC, sizeof(header.m_magic));
+	header.m_version = GENERATION_LOG_VERSION;
+	header.m_numElements = numElements;
+	m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	//starting board
+	for (unsigned int i = 0; i < numElements; ++i)
+		if (simulation.IsAlive(i))
+			AddEdit(i, simulation.GetState(i));
+	WriteRecord(LOG_EDIT, m_editIndices, m_editStates);
+	m_editIndices.clear();
+	m_editStates.clear();
+}
+
+GenerationLog::~GenerationLog(void) {
+	try {
+		if (!m_editIndices.empty())
+			WriteRecord(LOG_EDIT, m_editIndices, m_editStates);
+	} catch (std::string & err) {
+		printf("\n%s\n", err.c_str()); //log is still valid up to the last generation
+	}
+}
+
+void GenerationLog::AddEdit(unsigned int index, uint8_t state) {
+	m_editIndices.push_back(index);
+	m_editStates.push_back(state);
+}
+
+void GenerationLog::AddGeneration(const std::vector<uint32_t> & indices, const std::vector<uint8_t> & states) {
+	if (!m_editIndices.empty()) {
+		WriteRecord(LOG_EDIT, m_editIndices, m_editStates);
+		m_editIndices.clear();
+		m_editStates.clear();
+	}
+
+	++m_generation;
+	WriteRecord(LOG_GENERATION, indices, states);
+}
+
+void GenerationLog::WriteRecord(LogRecordKind kind, const std::vector<uint32_t> & indices, const std::vector<uint8_t> & states) {
+	static const char padding[8] = { };
+
+	LogRecord record;
+	record.m_generation = m_generation;
+	record.m_kind = kind;
+	record.m_numChanges = indices.size();
+	m_file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+	m_file.write(reinterpret_cast<const char *>(indices.data()), indices.size() * sizeof(uint32_t));
+	m_file.write(reinterpret_cast<const char *>(states.data()), states.size() * sizeof(uint8_t));
+	m_file.write(padding, GetRecordSize(record.m_numChanges) - sizeof(record) - indices.size() * sizeof(uint32_t) - states.size() * sizeof(uint8_t));
+
+	if (!m_file.good())
+		throw std::string("Could not write to generation log");
+}
+
+GenerationReplay::GenerationReplay(const std::string & fileName, unsigned int numElements) :
+		m_file(fileName), m_numElements(numElements), m_position(sizeof(LogHeader)), m_generation(0) {
+	if (m_file.GetSize() < sizeof(LogHeader))
+		throw std::string("Generation log is too small: " + fileName);
+
+	const LogHeader * header = reinterpret_cast<const LogHeader *>(m_file.GetData());
+	if (std::memcmp(header->m_magic, GENERATION_LOG_MAGIC, sizeof(header->m_magic)))
+		throw std::string("Not a generation log: " + fileName);
+	if (header->m_version != GENERATION_LOG_VERSION)
+		throw std::string("Unsupported generation log version " + std::to_string(header->m_version) + " in " + fileName);
+	if (header->m_numElements != numElements)
+		throw std::string("Generation log " + fileName + " was recorded on a board with " + std::to_string(header->m_numElements) + " elements");
+}
+
+GenerationReplay::~GenerationReplay(void) {
+}
+
+//edits before the first generation make up the starting board - there is nothing to show or keep before it, so they are applied here
+void GenerationReplay::Start(LifeSimulation & simulation) {
+	std::vector<uint32_t> indices;
+	std::vector<uint8_t> states;
+	m_generation = 0;
+	m_position = sizeof(LogHeader);
+	ReadEdits(m_position, m_generation, indices, states);
+
+	simulation.Clear();
+	for (unsigned int i = 0; i < indices.size(); ++i) {
+		if (!(states[i] & LIFE_STATE_ALIVE))
+			simulation.SetElement(indices[i], DEAD);
+		else
+			simulation.SetElement(indices[i], (states[i] & LIFE_STATE_PLAYER2) ? P2_ALIVE : P1_ALIVE);
+	}
+}
+
+bool GenerationReplay::NextEdits(std::vector<uint32_t> & indices, std::vector<uint8_t> & states) {
+	size_t position = m_position;
+	uint64_t generation = m_generation;
+	const LogRecord * record = ReadEdits(position, generation, indices, states);
+	if (!record) { //trailing edits are left where they are
+		indices.clear();
+		states.clear();
+		return false;
+	}
+	CheckRecord(record);
+
+	m_position = position;
+	m_generation = generation;
+	return true;
+}
+
+void GenerationReplay::NextGeneration(LifeSimulation & simulation) {
+	const LogRecord * record = PeekRecord(m_position);
+	if (!record || record->m_kind != LOG_GENERATION)
+		throw std::string("Generation log has no generation where one was expected");
+
+	const uint32_t * indices = reinterpret_cast<const uint32_t *>(record + 1);
+	const uint8_t * states = reinterpret_cast<const uint8_t *>(indices + record->m_numChanges);
+	simulation.ApplyChanges(indices, states, record->m_numChanges);
+
+	m_generation = record->m_generation;
+	m_position += GetRecordSize(record->m_numChanges);
+}
+
+uint64_t GenerationReplay::GetGeneration(void) const {
+	return m_generation;
+}
+
+//a log that was being written when the program stopped may end part way through a record, which is treated as the end
+const LogRecord * GenerationReplay::PeekRecord(size_t position) const {
+	size_t remaining = m_file.GetSize() - position;
+	if (remaining < sizeof(LogRecord))
+		return nullptr;
+
+	const LogRecord * record = reinterpret_cast<const LogRecord *>(m_file.GetData() + position);
+	if (remaining < GetRecordSize(record->m_numChanges))
+		return nullptr;
+	if (record->m_kind != LOG_GENERATION && record->m_kind != LOG_EDIT)
+		throw std::string("Unknown record in generation log: " + std::to_string(record->m_kind));
+
+	return record;
+}
+
+//collects edit records from position on - returns the record after them
+const LogRecord * GenerationReplay::ReadEdits(size_t & position, uint64_t & generation, std::vector<uint32_t> & indices,
+		std::vector<uint8_t> & states) const {
+	indices.clear();
+	states.clear();
+
+	const LogRecord * record = PeekRecord(position);
+	for (; record && record->m_kind == LOG_EDIT; record = PeekRecord(position)) {
+		CheckRecord(record);
+		const uint32_t * recordIndices = reinterpret_cast<const uint32_t *>(record + 1);
+		const uint8_t * recordStates = reinterpret_cast<const uint8_t *>(recordIndices + record->m_numChanges);
+		indices.insert(indices.end(), recordIndices, recordIndices + record->m_numChanges);
+		states.insert(states.end(), recordStates, recordStates + record->m_numChanges);
+
+		generation = record->m_generation;
+		position += GetRecordSize(record->m_numChanges);
+	}
+	return record;
+}
+
+void GenerationReplay::CheckRecord(const LogRecord * record) const {
+	const uint32_t * indices = reinterpret_cast<const uint32_t *>(record + 1);
+	for (unsigned int i = 0; i < record->m_numChanges; ++i)
+		if (indices[i] >= m_numElements)
+			throw std::string("Change of element " + std::to_string(indices[i]) + " is outside of the board");
+}
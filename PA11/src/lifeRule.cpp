@@ -0,0 +1,50 @@
+#include "lifeRule.h"
+
+#include <cctype>
+
+LifeRule ParseLifeRule(const std::string & rule) {
+	LifeRule result;
+	result.m_birth = result.m_survival = 0;
+
+	//"B" part & "S" part separated by '/', in either order
+	size_t slash = rule.find('/');
+	if (slash == std::string::npos || rule.find('/', slash + 1) != std::string::npos)
+		throw std::string("Rule " + rule + " is not in B/S notation (e.g. B3/S23)");
+
+	bool hasBirth = false, hasSurvival = false;
+	for (const std::string & part : { rule.substr(0, slash), rule.substr(slash + 1) }) {
+		char kind = (part.empty()) ? '\0' : std::toupper(part[0]);
+		if ((kind != 'B' || hasBirth) && (kind != 'S' || hasSurvival))
+			throw std::string("Rule " + rule + " needs one B part & one S part (e.g. B3/S23)");
+
+		uint16_t & mask = (kind == 'B') ? result.m_birth : result.m_survival;
+		((kind == 'B') ? hasBirth : hasSurvival) = true;
+		for (unsigned int i = 1; i < part.size(); ++i) {
+			if (part[i] < '0' || part[i] >= '0' + LIFE_RULE_COUNTS)
+				throw std::string("Rule " + rule + " has a neighbor count that is not 0 - 8: " + part[i]);
+			mask |= 1 << (part[i] - '0');
+		}
+	}
+
+	if (result.m_birth & 1)
+		throw std::string("Rule " + rule + " is not supported - B0 would bring every dead region to life");
+
+	for (unsigned int n = 0; n < LIFE_RULE_COUNTS; ++n) {
+		result.m_table[0][n] = (result.m_birth >> n) & 1;
+		result.m_table[1][n] = (result.m_survival >> n) & 1;
+	}
+	return result;
+}
+
+std::string LifeRuleToString(const LifeRule & rule) {
+	std::string result = "B";
+	for (unsigned int n = 0; n < LIFE_RULE_COUNTS; ++n)
+		if ((rule.m_birth >> n) & 1)
+			result += char('0' + n);
+
+	result += "/S";
+	for (unsigned int n = 0; n < LIFE_RULE_COUNTS; ++n)
+		if ((rule.m_survival >> n) & 1)
+			result += char('0' + n);
+	return result;
+}
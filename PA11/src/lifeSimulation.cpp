@@ -0,0 +1,621 @@
+#include "lifeSimulation.h"
+
+#include <algorithm>
+#include <cstring>
+
+//birth & survival masks of rules with a kernel of their own
+#define CONWAY_BIRTH (1 << 3)
+#define CONWAY_SURVIVAL ((1 << 2) | (1 << 3))
+#define HIGHLIFE_BIRTH ((1 << 3) | (1 << 6))
+#define DAY_NIGHT_BIRTH ((1 << 3) | (1 << 6) | (1 << 7) | (1 << 8))
+#define DAY_NIGHT_SURVIVAL ((1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8))
+#define SEEDS_BIRTH (1 << 2)
+#define SEEDS_SURVIVAL 0
+//mask no rule can have (counts only go up to 8) - kernel reads the mask of the rule instead
+#define LIFE_RULE_RUNTIME 0xFFFF
+
+//LIFE_LANES words handled as one value. Bitwise operators and shifts work lane by lane
+typedef uint64_t LifeWords __attribute__((vector_size(LIFE_LANES * sizeof(uint64_t))));
+
+namespace {
+
+inline LifeWords LoadWords(const uint64_t * src) {
+	LifeWords words;
+	std::memcpy(&words, src, sizeof(LifeWords));
+	return words;
+}
+
+inline void StoreWords(uint64_t * dest, const LifeWords & words) {
+	std::memcpy(dest, &words, sizeof(LifeWords));
+}
+
+//element c receives bit of element c - 1 (neighbor to the west) - carry comes from the previous word
+inline LifeWords ShiftWest(const uint64_t * row) {
+	return (LoadWords(row) << 1) | (LoadWords(row - 1) >> 63);
+}
+
+//element c receives bit of element c + 1 (neighbor to the east) - carry comes from the next word
+inline LifeWords ShiftEast(const uint64_t * row) {
+	return (LoadWords(row) >> 1) | (LoadWords(row + 1) << 63);
+}
+
+//carry save adder: adds 3 bits in each position
+inline void FullAdd(const LifeWords & a, const LifeWords & b, const LifeWords & c, LifeWords & sum, LifeWords & carry) {
+	LifeWords t = a ^ b;
+	sum = t ^ c;
+	carry = (a & b) | (t & c);
+}
+
+//adds up 8 neighbor bits in each position. count = b0 + 2 * b1 + 4 * b2 + 8 * b3
+inline void CountNeighbors(const LifeWords (&n)[8], LifeWords & b0, LifeWords & b1, LifeWords & b2, LifeWords & b3) {
+	LifeWords sA, cA, sB, cB, cD, sE, cE;
+	FullAdd(n[0], n[1], n[2], sA, cA);
+	FullAdd(n[3], n[4], n[5], sB, cB);
+	LifeWords sC = n[6] ^ n[7], cC = n[6] & n[7];
+
+	FullAdd(sA, sB, sC, b0, cD); //ones
+	FullAdd(cA, cB, cC, sE, cE); //twos
+	b1 = sE ^ cD;
+	LifeWords cF = sE & cD;
+	b2 = cE ^ cF; //fours
+	b3 = cE & cF; //eights
+}
+
+//elements whose count (b0 - b3, see CountNeighbors) is in mask - bit n of mask = count n
+//written out count by count, so a mask known when compiling leaves only the terms of its counts
+inline LifeWords MatchCounts(uint16_t mask, const LifeWords & b0, const LifeWords & b1, const LifeWords & b2, const LifeWords & b3) {
+	//8 is the only count with b3 set, so counts with a bit set in b0 - b2 do not need to check it
+	const LifeWords low = ~b2 & ~b1, high = b2 & b1;
+	LifeWords result = { };
+	if (mask & (1 << 0))
+		result |= low & ~b0 & ~b3;
+	if (mask & (1 << 1))
+		result |= low & b0;
+	if (mask & (1 << 2))
+		result |= ~b2 & b1 & ~b0;
+	if (mask & (1 << 3))
+		result |= ~b2 & b1 & b0;
+	if (mask & (1 << 4))
+		result |= b2 & ~b1 & ~b0;
+	if (mask & (1 << 5))
+		result |= b2 & ~b1 & b0;
+	if (mask & (1 << 6))
+		result |= high & ~b0;
+	if (mask & (1 << 7))
+		result |= high & b0;
+	if (mask & (1 << 8))
+		result |= b3;
+	return result;
+}
+
+//2 * red >= alive: most alive neighbors belong to player 2 (or as many as to player 1). Both counts are 4 bits (see CountNeighbors)
+inline LifeWords MostlyPlayer2(const LifeWords & a0, const LifeWords & a1, const LifeWords & a2, const LifeWords & a3, const LifeWords & r0,
+		const LifeWords & r1, const LifeWords & r2, const LifeWords & r3) {
+	//borrow of 2 * red - alive bit by bit - no borrow out of the top bit means the difference is not negative
+	LifeWords borrow = a0; //bit 0 of 2 * red is 0
+	borrow = (~r0 & a1) | (~(r0 ^ a1) & borrow);
+	borrow = (~r1 & a2) | (~(r1 ^ a2) & borrow);
+	borrow = (~r2 & a3) | (~(r2 ^ a3) & borrow);
+	return r3 | ~borrow; //bit 4 of alive is 0
+}
+
+//gathers 8 neighbors of each element in row from rows above and below
+inline void GatherNeighbors(const uint64_t * above, const uint64_t * row, const uint64_t * below, LifeWords (&n)[8]) {
+	n[0] = ShiftWest(above);
+	n[1] = LoadWords(above);
+	n[2] = ShiftEast(above);
+	n[3] = ShiftWest(row);
+	n[4] = ShiftEast(row);
+	n[5] = ShiftWest(below);
+	n[6] = LoadWords(below);
+	n[7] = ShiftEast(below);
+}
+
+//type shown on board. index = {alive, alive in last generation, owner, owner in last generation}
+const ObjType DERIVED_TYPES[16] = { DEAD, DEAD, DEAD, DEAD, //dead and was dead
+		P1_DEAD_FUTURE, P2_DEAD_FUTURE, P1_DEAD_FUTURE, P2_DEAD_FUTURE, //died this generation
+		P1_ALIVE_FUTURE, P1_ALIVE_FUTURE, P2_ALIVE_FUTURE, P2_ALIVE_FUTURE, //born this generation
+		P1_ALIVE, P1_ALIVE, P2_ALIVE, P2_ALIVE }; //lived on
+
+}
+
+LifeSimulation::LifeSimulation(const NeighborTable & neighborTable, unsigned int numThreads) :
+		m_neighborTable(neighborTable), m_current(0), m_numActiveRows(0), m_threadPool(numThreads) {
+	SetRule(ParseLifeRule(LIFE_DEFAULT_RULE));
+
+	//lay out the faces
+	unsigned int numWords = 0, numMaskWords = 0, numRows = 0;
+	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i) {
+		FaceLayout & face = m_faces[i];
+		face.m_rows = neighborTable.GetFaceSize(i).x;
+		face.m_cols = neighborTable.GetFaceSize(i).y;
+		face.m_words = (face.m_cols + 63) / 64;
+		face.m_stride = ((face.m_words + LIFE_LANES - 1) / LIFE_LANES) * LIFE_LANES + 2;
+		face.m_offset = numWords;
+		face.m_elementOffset = neighborTable.GetFaceOffset(i);
+		face.m_maskOffset = numMaskWords;
+		face.m_rowOffset = numRows;
+		numWords += (face.m_rows + 2) * face.m_stride;
+		numRows += face.m_rows;
+
+		//mask of valid columns in each word of a row
+		m_columnMasks.resize(numMaskWords + face.m_stride, 0);
+		m_interiorMasks.resize(numMaskWords + face.m_stride, 0);
+		for (unsigned int c = 0; c < face.m_cols; ++c) {
+			m_columnMasks[numMaskWords + 1 + c / 64] |= uint64_t(1) << (c % 64);
+			if (c != 0 && c != face.m_cols - 1)
+				m_interiorMasks[numMaskWords + 1 + c / 64] |= uint64_t(1) << (c % 64);
+		}
+		numMaskWords += face.m_stride;
+
+		//split face into bands of rows
+		unsigned int tileRows = std::max(1u, LIFE_TILE_WORDS / face.m_stride);
+		for (unsigned int r = 0; r < face.m_rows; r += tileRows)
+			m_rowTiles.push_back( { i, r, std::min(face.m_rows, r + tileRows) });
+	}
+
+	if (uint64_t(numWords) * 64 > UINT32_MAX)
+		throw std::string("Board is too large for the simulation: " + std::to_string(numWords) + " words");
+
+	for (unsigned int i = 0; i < 2; ++i) {
+		m_alive[i].resize(numWords, 0);
+		m_owner[i].resize(numWords, 0);
+	}
+
+	//every row starts out active so first steps go over the whole board
+	m_rowChanged.resize(numRows, 0);
+	m_rowQuiet.resize(numRows, 0);
+	m_numActiveRows = numRows;
+	m_activeTiles.reserve(m_rowTiles.size());
+
+	//find elements on the edge of each face and store their neighbors as bit positions
+	m_seamOffsets.push_back(0);
+	for (unsigned int i = 0; i < neighborTable.GetNumElements(); ++i) {
+		glm::uvec3 element = neighborTable.GetElement(i);
+		glm::uvec2 faceSize = neighborTable.GetFaceSize(element.x);
+		if (element.y != 0 && element.y != faceSize.x - 1 && element.z != 0 && element.z != faceSize.y - 1)
+			continue;
+
+		m_seamElements.push_back(GetBitPosition(i));
+		m_seamRows.push_back(m_faces[element.x].m_rowOffset + element.y);
+		for (const uint32_t * n = neighborTable.NeighborsBegin(i); n != neighborTable.NeighborsEnd(i); ++n)
+			m_seamNeighbors.push_back(GetBitPosition(*n));
+		m_seamOffsets.push_back(m_seamNeighbors.size());
+	}
+
+	//split edge elements into tiles. Edge elements write single bits and row activity, so a tile may only end where the row changes
+	m_seamTiles.push_back(0);
+	for (unsigned int i = 1; i < m_seamElements.size(); ++i)
+		if (i - m_seamTiles.back() >= LIFE_SEAM_TILE_ELEMENTS && m_seamRows[i] != m_seamRows[i - 1])
+			m_seamTiles.push_back(i);
+	m_seamTiles.push_back(m_seamElements.size());
+}
+
+LifeSimulation::~LifeSimulation(void) {
+}
+
+void LifeSimulation::SetElement(unsigned int index, const ObjType type) {
+	uint32_t bit = GetBitPosition(index);
+	uint64_t mask = uint64_t(1) << (bit % 64);
+
+	bool alive = (type == P1_ALIVE || type == P1_ALIVE_FUTURE || type == P1_ALIVE_MARKED || type == P2_ALIVE || type == P2_ALIVE_FUTURE
+			|| type == P2_ALIVE_MARKED);
+	bool player2 = (type == P2_ALIVE || type == P2_ALIVE_FUTURE || type == P2_ALIVE_MARKED);
+
+	uint64_t & aliveWord = m_alive[m_current][bit / 64];
+	uint64_t & ownerWord = m_owner[m_current][bit / 64];
+	aliveWord = (alive) ? (aliveWord | mask) : (aliveWord & ~mask);
+	ownerWord = (player2) ? (ownerWord | mask) : (ownerWord & ~mask);
+
+	//row has to be stepped again
+	glm::uvec3 element = m_neighborTable.GetElement(index);
+	MarkRowActive(element.x, element.y);
+}
+
+bool LifeSimulation::IsAlive(unsigned int index) const {
+	uint32_t bit = GetBitPosition(index);
+	return (m_alive[m_current][bit / 64] >> (bit % 64)) & 1;
+}
+
+void LifeSimulation::CopyFrom(const LifeSimulation & other) {
+	if (&other.m_neighborTable != &m_neighborTable)
+		throw std::string("Simulations of different boards can not be copied");
+
+	//vectors already have the right size, so copying never allocates
+	for (unsigned int i = 0; i < 2; ++i) {
+		std::copy(other.m_alive[i].begin(), other.m_alive[i].end(), m_alive[i].begin());
+		std::copy(other.m_owner[i].begin(), other.m_owner[i].end(), m_owner[i].begin());
+	}
+	m_current = other.m_current;
+	m_rule = other.m_rule;
+	m_stepRows = other.m_stepRows;
+
+	std::copy(other.m_rowChanged.begin(), other.m_rowChanged.end(), m_rowChanged.begin());
+	std::copy(other.m_rowQuiet.begin(), other.m_rowQuiet.end(), m_rowQuiet.begin());
+	m_numActiveRows = other.m_numActiveRows;
+}
+
+glm::uvec2 LifeSimulation::GetPopulation(void) const {
+	const std::vector<uint64_t> & alive = m_alive[m_current], & owner = m_owner[m_current];
+
+	//guard words & padding are always 0, so whole planes can be counted
+	glm::uvec2 population(0, 0);
+	for (unsigned int w = 0; w < alive.size(); ++w) {
+		population.x += __builtin_popcountll(alive[w] & ~owner[w]);
+		population.y += __builtin_popcountll(alive[w] & owner[w]);
+	}
+	return population;
+}
+
+void LifeSimulation::Clear(void) {
+	for (unsigned int i = 0; i < 2; ++i) {
+		std::fill(m_alive[i].begin(), m_alive[i].end(), 0);
+		std::fill(m_owner[i].begin(), m_owner[i].end(), 0);
+	}
+
+	//types derived from the last generation have to be rewritten everywhere
+	std::fill(m_rowQuiet.begin(), m_rowQuiet.end(), 0);
+	m_numActiveRows = m_rowQuiet.size();
+}
+
+void LifeSimulation::Step(void) {
+	//with lots of activity checking every row costs more than it saves
+	const bool fullSweep = (uint64_t(m_numActiveRows) * 100 > uint64_t(m_rowQuiet.size()) * LIFE_FULL_SWEEP_PERCENT);
+
+	m_activeTiles.clear();
+	for (unsigned int t = 0; t < m_rowTiles.size(); ++t)
+		if (fullSweep || IsTileActive(m_rowTiles[t]))
+			m_activeTiles.push_back(t);
+
+	//bands only read the planes of the last generation, so they can run in any order
+	m_threadPool.ParallelFor(m_activeTiles.size(), [this, fullSweep](unsigned int t) {
+		(this->*m_stepRows)(m_rowTiles[m_activeTiles[t]], fullSweep);
+	});
+
+	//edge elements overwrite bits the bands wrote, so wait until all bands are done
+	m_threadPool.ParallelFor(m_seamTiles.size() - 1, [this](unsigned int t) {
+		StepSeams(m_seamTiles[t], m_seamTiles[t + 1]);
+	});
+
+	UpdateActivity();
+	m_current ^= 1;
+}
+
+void LifeSimulation::SetRule(const LifeRule & rule) {
+	m_rule = rule;
+
+	if (rule.m_birth == CONWAY_BIRTH && rule.m_survival == CONWAY_SURVIVAL)
+		m_stepRows = &LifeSimulation::StepRows<CONWAY_BIRTH, CONWAY_SURVIVAL>;
+	else if (rule.m_birth == HIGHLIFE_BIRTH && rule.m_survival == CONWAY_SURVIVAL)
+		m_stepRows = &LifeSimulation::StepRows<HIGHLIFE_BIRTH, CONWAY_SURVIVAL>;
+	else if (rule.m_birth == DAY_NIGHT_BIRTH && rule.m_survival == DAY_NIGHT_SURVIVAL)
+		m_stepRows = &LifeSimulation::StepRows<DAY_NIGHT_BIRTH, DAY_NIGHT_SURVIVAL>;
+	else if (rule.m_birth == SEEDS_BIRTH && rule.m_survival == SEEDS_SURVIVAL)
+		m_stepRows = &LifeSimulation::StepRows<SEEDS_BIRTH, SEEDS_SURVIVAL>;
+	else
+		m_stepRows = &LifeSimulation::StepRows<LIFE_RULE_RUNTIME, LIFE_RULE_RUNTIME>;
+
+	//planes of the last generation were stepped with the old rule, so quiet rows may change now
+	std::fill(m_rowQuiet.begin(), m_rowQuiet.end(), 0);
+	m_numActiveRows = m_rowQuiet.size();
+}
+
+const LifeRule & LifeSimulation::GetRule(void) const {
+	return m_rule;
+}
+
+void LifeSimulation::WriteTypes(ObjType * types, unsigned int generationsAgo) const {
+	m_threadPool.ParallelFor(m_rowTiles.size(), [this, generationsAgo, types](unsigned int t) {
+		WriteRows(m_rowTiles[t], generationsAgo, types);
+	});
+}
+
+unsigned int LifeSimulation::GetNumActiveRows(void) const {
+	return m_numActiveRows;
+}
+
+//rows that did not change hold the same bits in both generations, so only active rows are compared
+void LifeSimulation::GetChanges(std::vector<uint32_t> & indices, std::vector<uint8_t> & states) const {
+	indices.clear();
+	states.clear();
+
+	const std::vector<uint64_t> & alive = m_alive[m_current], & alivePrev = m_alive[m_current ^ 1];
+	const std::vector<uint64_t> & owner = m_owner[m_current], & ownerPrev = m_owner[m_current ^ 1];
+
+	for (const FaceLayout & face : m_faces) {
+		for (unsigned int r = 0; r < face.m_rows; ++r) {
+			if (m_rowQuiet[face.m_rowOffset + r])
+				continue;
+
+			unsigned int word = face.m_offset + (r + 1) * face.m_stride + 1;
+			for (unsigned int w = 0; w < face.m_words; ++w, ++word) {
+				for (uint64_t bits = (alive[word] ^ alivePrev[word]) | (owner[word] ^ ownerPrev[word]); bits; bits &= bits - 1) {
+					unsigned int b = __builtin_ctzll(bits);
+					indices.push_back(face.m_elementOffset + r * face.m_cols + w * 64 + b);
+					states.push_back(((alive[word] >> b) & 1) * LIFE_STATE_ALIVE | ((owner[word] >> b) & 1) * LIFE_STATE_PLAYER2);
+				}
+			}
+		}
+	}
+}
+
+//rows that were active in the last step are the only ones that differ between the planes, so only they have to be copied forward
+void LifeSimulation::ApplyChanges(const uint32_t * indices, const uint8_t * states, unsigned int numChanges) {
+	//every change is checked before any plane is touched, so a broken log leaves the simulation as it was
+	for (unsigned int i = 0; i < numChanges; ++i)
+		if (indices[i] >= m_neighborTable.GetNumElements())
+			throw std::string("Change of element " + std::to_string(indices[i]) + " is outside of the board");
+
+	for (const FaceLayout & face : m_faces) {
+		for (unsigned int r = 0; r < face.m_rows; ++r) {
+			if (m_rowQuiet[face.m_rowOffset + r])
+				continue;
+
+			unsigned int word = face.m_offset + (r + 1) * face.m_stride;
+			std::copy(&m_alive[m_current][word], &m_alive[m_current][word] + face.m_stride, &m_alive[m_current ^ 1][word]);
+			std::copy(&m_owner[m_current][word], &m_owner[m_current][word] + face.m_stride, &m_owner[m_current ^ 1][word]);
+		}
+	}
+
+	std::vector<uint64_t> & aliveNext = m_alive[m_current ^ 1], & ownerNext = m_owner[m_current ^ 1];
+	for (unsigned int i = 0; i < numChanges; ++i) {
+		uint32_t bit = GetBitPosition(indices[i]);
+		uint64_t mask = uint64_t(1) << (bit % 64);
+		aliveNext[bit / 64] = (states[i] & LIFE_STATE_ALIVE) ? (aliveNext[bit / 64] | mask) : (aliveNext[bit / 64] & ~mask);
+		ownerNext[bit / 64] = (states[i] & LIFE_STATE_PLAYER2) ? (ownerNext[bit / 64] | mask) : (ownerNext[bit / 64] & ~mask);
+
+		glm::uvec3 element = m_neighborTable.GetElement(indices[i]);
+		m_rowChanged[m_faces[element.x].m_rowOffset + element.y] = 1;
+	}
+
+	UpdateActivity();
+	m_current ^= 1;
+}
+
+uint8_t LifeSimulation::GetState(unsigned int index) const {
+	uint32_t bit = GetBitPosition(index);
+	return ((m_alive[m_current][bit / 64] >> (bit % 64)) & 1) * LIFE_STATE_ALIVE
+			| ((m_owner[m_current][bit / 64] >> (bit % 64)) & 1) * LIFE_STATE_PLAYER2;
+}
+
+uint8_t LifeSimulation::GetLastState(unsigned int index) const {
+	uint32_t bit = GetBitPosition(index);
+	return ((m_alive[m_current ^ 1][bit / 64] >> (bit % 64)) & 1) * LIFE_STATE_ALIVE
+			| ((m_owner[m_current ^ 1][bit / 64] >> (bit % 64)) & 1) * LIFE_STATE_PLAYER2;
+}
+
+void LifeSimulation::ToggleElements(const uint32_t * indices, const uint8_t * toggles, unsigned int numToggles) {
+	for (unsigned int i = 0; i < numToggles; ++i) {
+		ToggleElement(m_current, indices[i], toggles[i]);
+
+		glm::uvec3 element = m_neighborTable.GetElement(indices[i]);
+		MarkRowActive(element.x, element.y);
+	}
+}
+
+//rows that were active in the last step are the only ones that differ between the planes, so only they have to be copied back
+void LifeSimulation::StepBack(const uint32_t * indices, const uint8_t * toggles, unsigned int numToggles) {
+	for (const FaceLayout & face : m_faces) {
+		for (unsigned int r = 0; r < face.m_rows; ++r) {
+			if (m_rowQuiet[face.m_rowOffset + r])
+				continue;
+
+			unsigned int word = face.m_offset + (r + 1) * face.m_stride;
+			std::copy(&m_alive[m_current ^ 1][word], &m_alive[m_current ^ 1][word] + face.m_stride, &m_alive[m_current][word]);
+			std::copy(&m_owner[m_current ^ 1][word], &m_owner[m_current ^ 1][word] + face.m_stride, &m_owner[m_current][word]);
+			m_rowChanged[face.m_rowOffset + r] = 1;
+		}
+	}
+
+	for (unsigned int i = 0; i < numToggles; ++i) {
+		ToggleElement(m_current, indices[i], toggles[i]);
+
+		glm::uvec3 element = m_neighborTable.GetElement(indices[i]);
+		m_rowChanged[m_faces[element.x].m_rowOffset + element.y] = 1;
+	}
+
+	UpdateActivity();
+	m_current ^= 1;
+}
+
+unsigned int LifeSimulation::GetRowWords(unsigned int face) const {
+	return m_faces[face].m_words;
+}
+
+const uint64_t * LifeSimulation::GetRow(unsigned int face, unsigned int row, const LifePlane plane) const {
+	return GetPlane(plane) + m_faces[face].m_offset + (row + 1) * m_faces[face].m_stride + 1;
+}
+
+void LifeSimulation::SetRow(unsigned int face, unsigned int row, const LifePlane plane, const uint64_t * words) {
+	const FaceLayout & layout = m_faces[face];
+	uint64_t * dest = const_cast<uint64_t *>(GetRow(face, row, plane));
+	const uint64_t * columnMask = &m_columnMasks[layout.m_maskOffset + 1];
+
+	for (unsigned int w = 0; w < layout.m_words; ++w)
+		dest[w] = words[w] & columnMask[w]; //keep bits past last column clear
+
+	MarkRowActive(face, row);
+}
+
+unsigned int LifeSimulation::GetNumThreads(void) const {
+	return m_threadPool.GetNumThreads();
+}
+
+uint32_t LifeSimulation::GetBitPosition(unsigned int index) const {
+	glm::uvec3 element = m_neighborTable.GetElement(index);
+	const FaceLayout & face = m_faces[element.x];
+	return (face.m_offset + (element.y + 1) * face.m_stride + 1) * 64 + element.z;
+}
+
+const uint64_t * LifeSimulation::GetPlane(const LifePlane plane) const {
+	switch (plane) {
+	case ALIVE_PLANE:
+		return &m_alive[m_current][0];
+	case OWNER_PLANE:
+		return &m_owner[m_current][0];
+	case ALIVE_LAST_PLANE:
+		return &m_alive[m_current ^ 1][0];
+	case OWNER_LAST_PLANE:
+		return &m_owner[m_current ^ 1][0];
+	default:
+		throw std::string("Invalid plane: " + std::to_string(plane));
+	}
+}
+
+void LifeSimulation::MarkRowActive(unsigned int face, unsigned int row) {
+	uint8_t & quiet = m_rowQuiet[m_faces[face].m_rowOffset + row];
+	if (quiet) {
+		quiet = 0;
+		++m_numActiveRows;
+	}
+}
+
+void LifeSimulation::ToggleElement(unsigned int buffer, unsigned int index, uint8_t toggle) {
+	if (index >= m_neighborTable.GetNumElements())
+		throw std::string("Element " + std::to_string(index) + " is outside of the board");
+
+	uint32_t bit = GetBitPosition(index);
+	m_alive[buffer][bit / 64] ^= uint64_t(toggle & LIFE_STATE_ALIVE) << (bit % 64);
+	m_owner[buffer][bit / 64] ^= uint64_t((toggle & LIFE_STATE_PLAYER2) >> 1) << (bit % 64);
+}
+
+bool LifeSimulation::IsTileActive(const RowTile & tile) const {
+	const FaceLayout & face = m_faces[tile.m_face];
+	unsigned int rowBegin = face.m_rowOffset + tile.m_rowBegin - (tile.m_rowBegin != 0);
+	unsigned int rowEnd = face.m_rowOffset + tile.m_rowEnd + (tile.m_rowEnd != face.m_rows);
+	for (unsigned int r = rowBegin; r < rowEnd; ++r)
+		if (!m_rowQuiet[r])
+			return true;
+	return false;
+}
+
+//derived types of a row only depend on the last two generations, so a row quiet for generationsAgo + 1 steps is already in types
+void LifeSimulation::WriteRows(const RowTile & tile, unsigned int generationsAgo, ObjType * types) const {
+	const std::vector<uint64_t> & alive = m_alive[m_current], & alivePrev = m_alive[m_current ^ 1];
+	const std::vector<uint64_t> & owner = m_owner[m_current], & ownerPrev = m_owner[m_current ^ 1];
+
+	const FaceLayout & face = m_faces[tile.m_face];
+	for (unsigned int r = tile.m_rowBegin; r < tile.m_rowEnd; ++r) {
+		if (generationsAgo && m_rowQuiet[face.m_rowOffset + r] > generationsAgo)
+			continue;
+
+		unsigned int word = face.m_offset + (r + 1) * face.m_stride + 1;
+		ObjType * rowTypes = types + face.m_elementOffset + r * face.m_cols;
+
+		for (unsigned int w = 0; w < face.m_words; ++w, ++word) {
+			unsigned int numBits = std::min(64u, face.m_cols - w * 64);
+			ObjType * wordTypes = rowTypes + w * 64;
+
+			std::fill(wordTypes, wordTypes + numBits, DEAD);
+
+			//only visit elements that are or were alive
+			for (uint64_t bits = alive[word] | alivePrev[word]; bits; bits &= bits - 1) {
+				unsigned int b = __builtin_ctzll(bits);
+				wordTypes[b] = DERIVED_TYPES[((alive[word] >> b) & 1) << 3 | ((alivePrev[word] >> b) & 1) << 2 | ((owner[word] >> b) & 1) << 1
+						| ((ownerPrev[word] >> b) & 1)];
+			}
+		}
+	}
+}
+
+//bitsliced kernel for rows of a tile. Only neighbors in the same face are counted
+//first and last row of a face are skipped as they are made up of edge elements only
+template<uint16_t BIRTH, uint16_t SURVIVAL>
+void LifeSimulation::StepRows(const RowTile & tile, bool fullSweep) {
+	const uint16_t birth = (BIRTH == LIFE_RULE_RUNTIME) ? m_rule.m_birth : BIRTH;
+	const uint16_t survival = (SURVIVAL == LIFE_RULE_RUNTIME) ? m_rule.m_survival : SURVIVAL;
+
+	const FaceLayout & layout = m_faces[tile.m_face];
+	const uint64_t * alive = &m_alive[m_current][0], *owner = &m_owner[m_current][0];
+	uint64_t * aliveNext = &m_alive[m_current ^ 1][0], *ownerNext = &m_owner[m_current ^ 1][0];
+	const uint64_t * columnMask = &m_columnMasks[layout.m_maskOffset];
+	const uint64_t * interiorMask = &m_interiorMasks[layout.m_maskOffset];
+	const uint8_t * rowQuiet = &m_rowQuiet[layout.m_rowOffset];
+
+	LifeWords n[8], b0, b1, b2, b3, r0, r1, r2, r3;
+	for (unsigned int r = std::max(tile.m_rowBegin, 1u); r < std::min(tile.m_rowEnd, layout.m_rows - 1); ++r) {
+		if (!fullSweep && rowQuiet[r - 1] && rowQuiet[r] && rowQuiet[r + 1])
+			continue;
+
+		unsigned int rowOffset = layout.m_offset + (r + 1) * layout.m_stride;
+		LifeWords changed = { };
+
+		for (unsigned int w = 1; w + 1 < layout.m_stride; w += LIFE_LANES) {
+			const uint64_t * row = alive + rowOffset + w;
+
+			//count of alive neighbors
+			GatherNeighbors(row - layout.m_stride, row, row + layout.m_stride, n);
+			CountNeighbors(n, b0, b1, b2, b3);
+
+			LifeWords self = LoadWords(row);
+			LifeWords next = (self & MatchCounts(survival, b0, b1, b2, b3)) | (~self & MatchCounts(birth, b0, b1, b2, b3));
+			next &= LoadWords(columnMask + w);
+
+			//count of player 2 neighbors - new elements take the color most of their neighbors have
+			const uint64_t * rowOwner = owner + rowOffset + w;
+			GatherNeighbors(rowOwner - layout.m_stride, rowOwner, rowOwner + layout.m_stride, n);
+			CountNeighbors(n, r0, r1, r2, r3);
+
+			//when elements are only born with 3 neighbors, 2 of player 2 are always most of them
+			LifeWords majority = (birth == (1 << 3)) ? (r1 | r2 | r3) : MostlyPlayer2(b0, b1, b2, b3, r0, r1, r2, r3);
+			LifeWords selfOwner = LoadWords(rowOwner);
+			LifeWords player2 = (next & self & selfOwner) | (next & ~self & majority);
+
+			//edge bits are redone by StepSeams, so only interior bits count as change
+			changed |= ((next ^ self) | (player2 ^ selfOwner)) & LoadWords(interiorMask + w);
+
+			StoreWords(aliveNext + rowOffset + w, next);
+			StoreWords(ownerNext + rowOffset + w, player2);
+		}
+
+		for (unsigned int l = 0; l < LIFE_LANES; ++l)
+			if (changed[l]) {
+				m_rowChanged[layout.m_rowOffset + r] = 1;
+				break;
+			}
+	}
+}
+
+//elements on the edges of faces are done one at a time with the neighbor table
+void LifeSimulation::StepSeams(unsigned int seamBegin, unsigned int seamEnd) {
+	const uint64_t * alive = &m_alive[m_current][0], *owner = &m_owner[m_current][0];
+	uint64_t * aliveNext = &m_alive[m_current ^ 1][0], *ownerNext = &m_owner[m_current ^ 1][0];
+
+	auto getBit = [](const uint64_t * plane, uint32_t bit)->unsigned int {
+		return (plane[bit / 64] >> (bit % 64)) & 1;
+	};
+
+	for (unsigned int i = seamBegin; i < seamEnd; ++i) {
+		unsigned int aliveNeighbors = 0, redNeighbors = 0;
+		for (unsigned int n = m_seamOffsets[i]; n < m_seamOffsets[i + 1]; ++n) {
+			aliveNeighbors += getBit(alive, m_seamNeighbors[n]);
+			redNeighbors += getBit(owner, m_seamNeighbors[n]);
+		}
+
+		uint32_t bit = m_seamElements[i];
+		bool isAlive = getBit(alive, bit);
+		bool nextAlive = m_rule.m_table[isAlive][std::min(aliveNeighbors, LIFE_RULE_COUNTS - 1u)];
+		bool nextPlayer2 = nextAlive && ((isAlive) ? getBit(owner, bit) : (redNeighbors >= aliveNeighbors - redNeighbors));
+
+		if (nextAlive != isAlive || nextPlayer2 != bool(getBit(owner, bit)))
+			m_rowChanged[m_seamRows[i]] = 1;
+
+		uint64_t mask = uint64_t(1) << (bit % 64);
+		aliveNext[bit / 64] = (nextAlive) ? (aliveNext[bit / 64] | mask) : (aliveNext[bit / 64] & ~mask);
+		ownerNext[bit / 64] = (nextPlayer2) ? (ownerNext[bit / 64] | mask) : (ownerNext[bit / 64] & ~mask);
+	}
+}
+
+//move changes of this step into the quiet count of each row
+void LifeSimulation::UpdateActivity(void) {
+	m_numActiveRows = 0;
+	for (unsigned int r = 0; r < m_rowQuiet.size(); ++r) {
+		if (m_rowChanged[r]) {
+			m_rowQuiet[r] = 0;
+			m_rowChanged[r] = 0;
+			++m_numActiveRows;
+		} else if (m_rowQuiet[r] < UINT8_MAX) {
+			++m_rowQuiet[r];
+		}
+	}
+}
@@ -1,10 +1,12 @@
 #include "menu.h"
 
-Menu::Menu(const SDL_GLContext & gl_context, const glm::vec3 & eyeLoc, const glm::vec3 & eyeFocus, const glm::uvec2 & menuSize) :
-		m_window(nullptr), m_eyeLoc(eyeLoc), m_eyeFocus(eyeFocus), m_menuSize(menuSize), m_menuTL(50, 50) {
+Menu::Menu(SDL_Window * mainWindow, const SDL_GLContext & gl_context, const glm::vec3 & eyeLoc, const glm::vec3 & eyeFocus, const glm::uvec2 & menuSize,
+		bool ownWindow) :
+		m_window(mainWindow), m_mainWindow(mainWindow), m_ownWindow(ownWindow), m_eyeLoc(eyeLoc), m_eyeFocus(eyeFocus), m_menuSize(menuSize), m_menuTL(50, 50) {
 	UpdateMenuParams();
 
-	m_window = SDL_CreateWindow("Menu", m_menuTL.y, m_menuTL.x, m_menuSize.y, m_menuSize.x, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+	if (m_ownWindow)
+		m_window = SDL_CreateWindow("Menu", m_menuTL.y, m_menuTL.x, m_menuSize.y, m_menuSize.x, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
 
 	const char * glsl_version = "#version 330";
 	// Setup Dear ImGui binding
@@ -22,10 +24,11 @@ Menu::~Menu(void) {
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplSDL2_Shutdown();
 	ImGui::DestroyContext();
-	SDL_DestroyWindow (m_window);
+	if (m_ownWindow)
+		SDL_DestroyWindow (m_window);
 }
 
-bool Menu::Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEyeLoc, const glm::vec3 & currentEyeFocus) {
+bool Menu::Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEyeLoc, const glm::vec3 & currentEyeFocus, const FramePacer & pacer) {
 
 	bool updated = false;
 
@@ -34,8 +37,15 @@ bool Menu::Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEy
 	ImGui_ImplSDL2_NewFrame (m_window);
 	ImGui::NewFrame();
 
-	ImGui::SetNextWindowPos(ImVec2(0.0, 0.0));
-	ImGui::SetNextWindowSize(ImVec2((m_menuSize.y) > 25 ? m_menuSize.y - 25 : 0, (m_menuSize.x) > 25 ? m_menuSize.x - 25 : 0));
+	if (m_ownWindow) {
+		ImGui::SetNextWindowPos(ImVec2(0.0, 0.0));
+		ImGui::SetNextWindowSize(ImVec2((m_menuSize.y) > 25 ? m_menuSize.y - 25 : 0, (m_menuSize.x) > 25 ? m_menuSize.x - 25 : 0));
+	} else {
+		//overlay starts in the top left corner & can be moved, resized or collapsed from there
+		ImGui::SetNextWindowPos(ImVec2(m_menuTL.y, m_menuTL.x), ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowSize(ImVec2(m_menuSize.y, m_menuSize.x), ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowBgAlpha(0.8f);
+	}
 	ImGui::Begin("Menu");
 
 	ImGui::Text("Use this section of the menu to move the camera around.");
@@ -56,27 +66,64 @@ bool Menu::Update(const SDL_GLContext & gl_context, const glm::vec3 & currrentEy
 
 	ImGui::Text("\n");
 	ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+
+	//frame times of the last PACER_HISTORY frames, measured where frames are presented
+	FramePacing pacing = pacer.GetPacing();
+	if (pacer.GetMode() == PACING_CAPPED)
+		ImGui::Text("Pacing: %s at %.0f FPS", FramePacer::GetModeName(pacer.GetMode()), pacer.GetFrameCap());
+	else
+		ImGui::Text("Pacing: %s", FramePacer::GetModeName(pacer.GetMode()));
+	ImGui::Text("Frame time %.2f ms, jitter %.3f ms, worst %.2f ms", pacing.m_mean, pacing.m_jitter, pacing.m_max);
 	ImGui::End();
 
 	// Rendering
 	ImGui::Render();
-	SDL_GL_MakeCurrent(m_window, gl_context);
-	glClearColor(0.0, 0.0, 0.2, 1.0);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-	SDL_GL_SwapWindow(m_window);
+	if (m_ownWindow) {
+		SDL_GL_MakeCurrent(m_window, gl_context);
+		glClearColor(0.0, 0.0, 0.2, 1.0);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		SDL_GL_SwapWindow(m_window);
+		SDL_GL_MakeCurrent(m_mainWindow, gl_context);
+	} else {
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData()); //over the scene - presented with it by the swap of the main window
+	}
 
 	return updated;
 }
 
-void Menu::HandleEvent(SDL_Event event) {
+bool Menu::HandleEvent(SDL_Event event) {
 	ImGui_ImplSDL2_ProcessEvent(&event);
+	if (m_ownWindow)
+		return true;
+
+	const ImGuiIO & io = ImGui::GetIO();
+	if (event.type == SDL_MOUSEMOTION || event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEWHEEL)
+		return io.WantCaptureMouse;
+	if (event.type == SDL_KEYDOWN || event.type == SDL_TEXTINPUT)
+		return io.WantCaptureKeyboard;
+	return false; //releases reach the game as well, so nothing is left held down
+}
+
+void Menu::UseMouse(bool use) {
+	if (m_ownWindow)
+		return;
+
+	ImGuiIO & io = ImGui::GetIO();
+	if (use)
+		io.ConfigFlags &= ~(ImGuiConfigFlags_NoMouse | ImGuiConfigFlags_NoMouseCursorChange);
+	else
+		io.ConfigFlags |= ImGuiConfigFlags_NoMouse | ImGuiConfigFlags_NoMouseCursorChange;
 }
 
 SDL_Window * Menu::GetWindow(void) {
 	return m_window;
 }
 
+bool Menu::HasWindow(void) const {
+	return m_ownWindow;
+}
+
 glm::vec3 Menu::GetEyeLocation(void) const {
 	return m_eyeLoc;
 }
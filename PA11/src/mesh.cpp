@@ -0,0 +1,108 @@
+#include "mesh.h"
+#include "trace.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <assimp/color4.h>
+
+std::map<std::string, std::weak_ptr<Mesh>> Mesh::s_meshes;
+
+Mesh::Mesh(const std::vector<Vertex> & vertices, const std::vector<unsigned int> & indices) :
+		m_numIndices(indices.size()), VB(0), IB(0) {
+
+	glGenBuffers(1, &VB);
+	glBindBuffer(GL_ARRAY_BUFFER, VB);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), &vertices[0], GL_STATIC_DRAW);
+
+	glGenBuffers(1, &IB);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IB);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), &indices[0], GL_STATIC_DRAW);
+}
+
+Mesh::~Mesh(void) {
+	glDeleteBuffers(1, &VB);
+	glDeleteBuffers(1, &IB);
+}
+
+std::shared_ptr<Mesh> Mesh::Get(const std::string & objFile) {
+	std::shared_ptr<Mesh> mesh = s_meshes[objFile].lock();
+	if (!mesh) {
+		TRACE_SCOPE("Load mesh");
+		//vertex attributes: vec3 position, vec3 color, vec2 uv, vec3 normal
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		LoadObjAssimp(objFile, vertices, indices);
+
+		mesh.reset(new Mesh(vertices, indices));
+		s_meshes[objFile] = mesh;
+	}
+	return mesh;
+}
+
+std::shared_ptr<Mesh> Mesh::GetQuad(void) {
+	std::shared_ptr<Mesh> mesh = s_meshes[MESH_QUAD_NAME].lock();
+	if (!mesh) {
+		std::vector<Vertex> vertices;
+		const glm::vec2 corners[4] = { glm::vec2(-1.f, -1.f), glm::vec2(1.f, -1.f), glm::vec2(1.f, 1.f), glm::vec2(-1.f, 1.f) };
+		for (const glm::vec2 & corner : corners)
+			vertices.emplace_back(glm::vec3(corner, 1.f), glm::vec3(0.f, 0.f, 1.f), (corner + glm::vec2(1.f)) * 0.5f);
+
+		//counter clockwise seen from the inside of the board, so the back of the quad can be culled
+		mesh.reset(new Mesh(vertices, { 0, 1, 2, 0, 2, 3 }));
+		s_meshes[MESH_QUAD_NAME] = mesh;
+	}
+	return mesh;
+}
+
+void Mesh::Render(unsigned int numInstances) {
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+
+	glBindBuffer(GL_ARRAY_BUFFER, VB);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, m_vertex));
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, m_normal));
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, m_texture));
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IB);
+
+	glDrawElementsInstanced(GL_TRIANGLES, m_numIndices, GL_UNSIGNED_INT, 0, numInstances);
+
+	glDisableVertexAttribArray(0);
+	glDisableVertexAttribArray(1);
+	glDisableVertexAttribArray(2);
+}
+
+void Mesh::LoadObjAssimp(const std::string & objFile, std::vector<Vertex> & vertices, std::vector<unsigned int> & indices) {
+	Assimp::Importer importer;
+	const aiScene * scene = importer.ReadFile(objFile, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
+	const aiMesh * currMesh;
+
+	const aiVector3D *tempVertex, *tempNormal, *tempUV;
+
+	if (!scene)
+		throw std::string("Error loading object: " + std::string(importer.GetErrorString()));
+
+	for (unsigned int meshNum = 0; meshNum < scene->mNumMeshes; ++meshNum) {
+		currMesh = scene->mMeshes[meshNum];
+
+		if (!currMesh->HasTextureCoords(0))
+			throw std::string("Object has no texture coordinates. Cannot load object");
+
+		for (unsigned int faceNum = 0; faceNum < currMesh->mNumFaces; ++faceNum) {
+
+			//iterate through each index of face - should be 3 for triangles
+			for (unsigned int indexNum = 0; indexNum < currMesh->mFaces[faceNum].mNumIndices; ++indexNum) {
+				tempVertex = &currMesh->mVertices[currMesh->mFaces[faceNum].mIndices[indexNum]];
+				tempNormal = &currMesh->mNormals[currMesh->mFaces[faceNum].mIndices[indexNum]];
+				tempUV = &currMesh->mTextureCoords[0][currMesh->mFaces[faceNum].mIndices[indexNum]];
+
+				//add vertex and index to internal array
+				vertices.emplace_back(glm::vec3(tempVertex->x, tempVertex->y, tempVertex->z),
+						glm::vec3(tempNormal->x, tempNormal->y, tempNormal->z), glm::vec2(tempUV->x, tempUV->y));
+				indices.push_back(vertices.size() - 1);
+			}
+		}
+	}
+}
@@ -0,0 +1,185 @@
+#include "neighborTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+NeighborTable::NeighborTable(const BoardInfo (&sides)[BoardSides::NUM_SIDES]) {
+	//lay out faces one after another
+	m_faceOffsets[0] = 0;
+	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i) {
+		m_faceSizes[i] = sides[i].m_size;
+		m_faceOffsets[i + 1] = m_faceOffsets[i] + m_faceSizes[i].x * m_faceSizes[i].y;
+	}
+
+#ifdef DEBUG
+	printf("\nBuilding neighbor table for %u elements\n", GetNumElements());
+#endif
+
+	if (!GetNumElements())
+		throw std::string("Board has no elements");
+
+	//find neighbors of every element once and flatten them
+	std::vector<glm::ivec3> points;
+	FindLatticePoints(sides, points);
+	BuildNeighbors(points);
+	CheckFaces();
+}
+
+NeighborTable::~NeighborTable(void) {
+}
+
+unsigned int NeighborTable::GetNumElements(void) const {
+	return m_faceOffsets[BoardSides::NUM_SIDES];
+}
+
+glm::uvec2 NeighborTable::GetFaceSize(unsigned int face) const {
+	return m_faceSizes[face];
+}
+
+unsigned int NeighborTable::GetFaceOffset(unsigned int face) const {
+	return m_faceOffsets[face];
+}
+
+//element = {face - BoardSides enumeration, row, column}
+unsigned int NeighborTable::GetIndex(const glm::uvec3 & element) const {
+	if (element.x >= BoardSides::NUM_SIDES || !IsValidElement(element.x, element.y, element.z))
+		throw std::string("Invalid element: " + glm::to_string(element));
+	return m_faceOffsets[element.x] + element.y * m_faceSizes[element.x].y + element.z;
+}
+
+glm::uvec3 NeighborTable::GetElement(unsigned int index) const {
+	if (index >= GetNumElements())
+		throw std::string("Invalid element index: " + std::to_string(index));
+
+	unsigned int face = 0;
+	while (index >= m_faceOffsets[face + 1])
+		++face;
+
+	index -= m_faceOffsets[face];
+	return glm::uvec3(face, index / m_faceSizes[face].y, index % m_faceSizes[face].y);
+}
+
+unsigned int NeighborTable::GetNumNeighbors(unsigned int index) const {
+	return m_rowOffsets[index + 1] - m_rowOffsets[index];
+}
+
+bool NeighborTable::IsValidElement(unsigned int face, unsigned int r, unsigned int c) const {
+	return (r < m_faceSizes[face].x && c < m_faceSizes[face].y);
+}
+
+//positions of all elements on the lattice covering the surface of the board, in units of the spacing between elements
+//spacing is the smallest step between neighboring elements of any face
+void NeighborTable::FindLatticePoints(const BoardInfo (&sides)[BoardSides::NUM_SIDES], std::vector<glm::ivec3> & points) const {
+	float spacing = 0.f;
+	for (unsigned int i = 0; i < BoardSides::NUM_SIDES; ++i)
+		for (const glm::vec3 & step : { sides[i].m_changeRow, sides[i].m_changeCol })
+			for (unsigned int a = 0; a < 3; ++a)
+				if (std::abs(step[a]) > 0.f && (spacing == 0.f || std::abs(step[a]) < spacing))
+					spacing = std::abs(step[a]);
+	if (spacing == 0.f)
+		throw std::string("Faces of the board have no spacing between elements");
+
+	points.resize(GetNumElements());
+	for (unsigned int i = 0; i < GetNumElements(); ++i) {
+		glm::uvec3 element = GetElement(i);
+		const BoardInfo & side = sides[element.x];
+		glm::vec3 position = side.m_startingLoc + float(element.y) * side.m_changeRow + float(element.z) * side.m_changeCol;
+		points[i] = glm::ivec3(glm::round(position / spacing));
+	}
+}
+
+//elements are neighbors if they are next to each other (diagonals included) in one of the planes of the box the board covers
+//elements on an edge of the box are in 2 planes & elements on a corner in 3, so faces meet without any special cases
+void NeighborTable::BuildNeighbors(const std::vector<glm::ivec3> & points) {
+	glm::ivec3 low = points[0], high = points[0];
+	for (const glm::ivec3 & p : points) {
+		low = glm::min(low, p);
+		high = glm::max(high, p);
+	}
+	const glm::ivec3 size = high - low + glm::ivec3(1);
+
+	//element at every point of each plane: plane 2 * a is at low[a], plane 2 * a + 1 at high[a]
+	//points of a plane are indexed by the other two axes
+	auto planeAxes = [](unsigned int axis)->glm::uvec2 {
+		return glm::uvec2((axis + 1) % 3, (axis + 2) % 3);
+	};
+	std::vector<uint32_t> planes[6];
+	for (unsigned int p = 0; p < 6; ++p) {
+		glm::uvec2 axes = planeAxes(p / 2);
+		planes[p].resize(size_t(size[axes.x]) * size[axes.y], UINT32_MAX);
+	}
+
+	auto isOnPlane = [&low, &high](const glm::ivec3 & point, unsigned int plane)->bool {
+		return point[plane / 2] == ((plane % 2) ? high[plane / 2] : low[plane / 2]);
+	};
+
+	for (unsigned int i = 0; i < points.size(); ++i) {
+		glm::ivec3 point = points[i] - low;
+		bool onSurface = false;
+		for (unsigned int p = 0; p < 6; ++p) {
+			if (!isOnPlane(points[i], p))
+				continue;
+
+			glm::uvec2 axes = planeAxes(p / 2);
+			uint32_t & entry = planes[p][size_t(point[axes.x]) * size[axes.y] + point[axes.y]];
+			if (entry != UINT32_MAX)
+				throw std::string("Elements " + glm::to_string(GetElement(entry)) + " and " + glm::to_string(GetElement(i)) + " are in the same place");
+			entry = i;
+			onSurface = true;
+		}
+		if (!onSurface)
+			throw std::string("Element " + glm::to_string(GetElement(i)) + " is inside the board instead of on its surface");
+	}
+
+	for (unsigned int p = 0; p < 6; ++p)
+		for (uint32_t entry : planes[p])
+			if (entry == UINT32_MAX)
+				throw std::string("Faces of the board leave a hole in side " + std::to_string(p) + " of the box they cover");
+
+	m_rowOffsets.resize(GetNumElements() + 1);
+	m_neighbors.reserve(GetNumElements() * 8);
+	for (unsigned int i = 0; i < points.size(); ++i) {
+		m_rowOffsets[i] = m_neighbors.size();
+
+		glm::ivec3 point = points[i] - low;
+		for (unsigned int p = 0; p < 6; ++p) {
+			if (!isOnPlane(points[i], p))
+				continue;
+
+			glm::uvec2 axes = planeAxes(p / 2);
+			for (int du = -1; du <= 1; ++du) {
+				for (int dv = -1; dv <= 1; ++dv) {
+					int u = point[axes.x] + du, v = point[axes.y] + dv;
+					if ((!du && !dv) || u < 0 || v < 0 || u >= size[axes.x] || v >= size[axes.y])
+						continue;
+
+					//elements on edges are found from both of their planes
+					uint32_t neighbor = planes[p][size_t(u) * size[axes.y] + v];
+					if (std::find(m_neighbors.begin() + m_rowOffsets[i], m_neighbors.end(), neighbor) == m_neighbors.end())
+						m_neighbors.push_back(neighbor);
+				}
+			}
+		}
+	}
+	m_rowOffsets[GetNumElements()] = m_neighbors.size();
+	m_neighbors.shrink_to_fit();
+}
+
+//the simulation counts neighbors of elements away from the edges of a face within the face only
+void NeighborTable::CheckFaces(void) const {
+	for (unsigned int i = 0; i < GetNumElements(); ++i) {
+		glm::uvec3 element = GetElement(i);
+		glm::uvec2 faceSize = m_faceSizes[element.x];
+		if (element.y == 0 || element.z == 0 || element.y == faceSize.x - 1 || element.z == faceSize.y - 1)
+			continue;
+
+		bool inFace = (GetNumNeighbors(i) == 8);
+		for (const uint32_t * n = NeighborsBegin(i); inFace && n != NeighborsEnd(i); ++n) {
+			glm::uvec3 neighbor = GetElement(*n);
+			inFace = (neighbor.x == element.x && neighbor.y + 1 >= element.y && neighbor.y <= element.y + 1 && neighbor.z + 1 >= element.z
+					&& neighbor.z <= element.z + 1);
+		}
+		if (!inFace)
+			throw std::string("Element " + glm::to_string(element) + " does not have the 8 neighbors of its face - face is not laid out in a grid");
+	}
+}
@@ -0,0 +1,101 @@
+#include "threadPool.h"
+#include "trace.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int numThreads) :
+		m_task(nullptr), m_loop(0), m_busyWorkers(0), m_shutdown(false) {
+	if (!numThreads)
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	m_queues.reset(new TaskQueue[numThreads]);
+	for (unsigned int i = 0; i < numThreads; ++i) {
+		m_queues[i].m_next.store(0);
+		m_queues[i].m_end = 0;
+	}
+
+	//calling thread is the first thread of the pool
+	for (unsigned int i = 1; i < numThreads; ++i)
+		m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool(void) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_startCondition.notify_all();
+
+	for (std::thread & worker : m_workers)
+		worker.join();
+}
+
+unsigned int ThreadPool::GetNumThreads(void) const {
+	return m_workers.size() + 1;
+}
+
+void ThreadPool::ParallelFor(unsigned int numTasks, const std::function<void(unsigned int)> & task) {
+	ParallelFor(numTasks, [&task](unsigned int i, unsigned int) {
+		task(i);
+	});
+}
+
+void ThreadPool::ParallelFor(unsigned int numTasks, const std::function<void(unsigned int, unsigned int)> & task) {
+	if (m_workers.empty() || numTasks <= 1) {
+		for (unsigned int i = 0; i < numTasks; ++i)
+			task(i, 0);
+		return;
+	}
+
+	const unsigned int numThreads = GetNumThreads();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (unsigned int i = 0; i < numThreads; ++i) {
+			m_queues[i].m_next.store(uint64_t(numTasks) * i / numThreads, std::memory_order_relaxed);
+			m_queues[i].m_end = uint64_t(numTasks) * (i + 1) / numThreads;
+		}
+		m_task = &task;
+		m_busyWorkers = m_workers.size();
+		++m_loop;
+	}
+	m_startCondition.notify_all();
+
+	RunTasks(0);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [this] {return m_busyWorkers == 0;});
+	m_task = nullptr;
+}
+
+void ThreadPool::WorkerLoop(unsigned int queue) {
+	TRACE_THREAD_NAME("Pool worker");
+	unsigned int lastLoop = 0;
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (true) {
+		m_startCondition.wait(lock, [this, lastLoop] {return m_shutdown || m_loop != lastLoop;});
+		if (m_shutdown)
+			return;
+		lastLoop = m_loop;
+
+		lock.unlock();
+		RunTasks(queue);
+		lock.lock();
+
+		if (--m_busyWorkers == 0)
+			m_doneCondition.notify_one();
+	}
+}
+
+//one event per thread & loop rather than per task - tasks can be too small to time one by one
+void ThreadPool::RunTasks(unsigned int queue) {
+	TRACE_SCOPE("Parallel tasks");
+	const unsigned int numThreads = GetNumThreads();
+
+	//own tasks first, then go around the other threads and steal what is left
+	for (unsigned int i = 0; i < numThreads; ++i) {
+		TaskQueue & victim = m_queues[(queue + i) % numThreads];
+		for (unsigned int t = victim.m_next.fetch_add(1); t < victim.m_end; t = victim.m_next.fetch_add(1))
+			(*m_task)(t, queue);
+	}
+}
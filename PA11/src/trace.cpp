@@ -0,0 +1,154 @@
+#include "trace.h"
+
+#ifdef USE_TRACING
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdio>
+
+typedef struct TraceEvent {
+	const char * m_name;
+	uint64_t m_time; //nanoseconds since trace started
+	uint64_t m_duration; //nanoseconds - complete events only
+	double m_value; //counters only
+	char m_phase; //'X' = complete, 'B' = begin, 'E' = end, 'C' = counter
+} TraceEvent;
+
+typedef struct TraceChunk {
+	TraceEvent m_events[TRACE_CHUNK_EVENTS];
+} TraceChunk;
+
+//events of one thread. Only the thread itself writes - an event is published by bumping the count after it is written
+typedef struct TraceBuffer {
+	std::atomic<TraceChunk *> m_chunks[TRACE_MAX_CHUNKS];
+	std::atomic<uint32_t> m_numEvents;
+	std::atomic<uint32_t> m_numDropped;
+	std::atomic<const char *> m_name;
+	unsigned int m_id;
+
+	TraceBuffer(unsigned int id) :
+			m_numEvents(0), m_numDropped(0), m_name(nullptr), m_id(id) {
+		for (std::atomic<TraceChunk *> & chunk : m_chunks)
+			chunk.store(nullptr, std::memory_order_relaxed);
+	}
+
+	~TraceBuffer(void) {
+		for (std::atomic<TraceChunk *> & chunk : m_chunks)
+			delete chunk.load(std::memory_order_relaxed);
+	}
+} TraceBuffer;
+
+typedef std::chrono::steady_clock TraceClock;
+
+//buffers are kept until exit, so events of threads that are gone can still be written
+static std::mutex s_buffersMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> s_buffers;
+static const TraceClock::time_point s_start = TraceClock::now();
+static thread_local TraceBuffer * t_buffer = nullptr;
+
+static uint64_t TraceNow(void) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(TraceClock::now() - s_start).count();
+}
+
+static TraceBuffer & GetBuffer(void) {
+	if (!t_buffer) {
+		std::lock_guard<std::mutex> lock(s_buffersMutex);
+		s_buffers.emplace_back(new TraceBuffer(s_buffers.size() + 1));
+		t_buffer = s_buffers.back().get();
+	}
+	return *t_buffer;
+}
+
+static void Record(char phase, const char * name, uint64_t time, uint64_t duration = 0, double value = 0.0) {
+	TraceBuffer & buffer = GetBuffer();
+	uint32_t index = buffer.m_numEvents.load(std::memory_order_relaxed);
+	if (index >= TRACE_MAX_CHUNKS * TRACE_CHUNK_EVENTS) {
+		buffer.m_numDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	TraceChunk * chunk = buffer.m_chunks[index / TRACE_CHUNK_EVENTS].load(std::memory_order_relaxed);
+	if (!chunk) {
+		chunk = new TraceChunk;
+		buffer.m_chunks[index / TRACE_CHUNK_EVENTS].store(chunk, std::memory_order_relaxed);
+	}
+
+	TraceEvent & event = chunk->m_events[index % TRACE_CHUNK_EVENTS];
+	event.m_name = name;
+	event.m_time = time;
+	event.m_duration = duration;
+	event.m_value = value;
+	event.m_phase = phase;
+	buffer.m_numEvents.store(index + 1, std::memory_order_release);
+}
+
+TraceScope::TraceScope(const char * name) :
+		m_name(name), m_start(TraceNow()) {
+}
+
+TraceScope::~TraceScope(void) {
+	Record('X', m_name, m_start, TraceNow() - m_start);
+}
+
+void TraceBegin(const char * name) {
+	Record('B', name, TraceNow());
+}
+
+void TraceEnd(const char * name) {
+	Record('E', name, TraceNow());
+}
+
+void TraceCounter(const char * name, double value) {
+	Record('C', name, TraceNow(), 0, value);
+}
+
+void TraceThreadName(const char * name) {
+	GetBuffer().m_name.store(name, std::memory_order_release);
+}
+
+bool TraceWrite(const std::string & fileName) {
+	FILE * file = fopen(fileName.c_str(), "w");
+	if (!file)
+		return false;
+
+	std::lock_guard<std::mutex> lock(s_buffersMutex);
+	uint64_t written = 0, dropped = 0;
+	bool first = true;
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+	for (const std::unique_ptr<TraceBuffer> & buffer : s_buffers) {
+		const char * threadName = buffer->m_name.load(std::memory_order_acquire);
+		if (threadName) {
+			fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", first ? "" : ",",
+					buffer->m_id, threadName);
+			first = false;
+		}
+
+		//only events published before this point are read - the thread can keep recording meanwhile
+		uint32_t numEvents = buffer->m_numEvents.load(std::memory_order_acquire);
+		for (uint32_t i = 0; i < numEvents; ++i) {
+			const TraceEvent & event = buffer->m_chunks[i / TRACE_CHUNK_EVENTS].load(std::memory_order_relaxed)->m_events[i % TRACE_CHUNK_EVENTS];
+			fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u", first ? "" : ",", event.m_name, event.m_phase,
+					event.m_time / 1000.0, buffer->m_id);
+			if (event.m_phase == 'X')
+				fprintf(file, ",\"dur\":%.3f", event.m_duration / 1000.0);
+			else if (event.m_phase == 'C')
+				fprintf(file, ",\"args\":{\"value\":%g}", event.m_value);
+			fprintf(file, "}");
+			first = false;
+		}
+		written += numEvents;
+		dropped += buffer->m_numDropped.load(std::memory_order_relaxed);
+	}
+
+	fprintf(file, "\n]}\n");
+	bool ok = !ferror(file);
+	fclose(file);
+
+	printf("Trace: %llu events written to %s (%llu dropped)\n", (unsigned long long) written, fileName.c_str(), (unsigned long long) dropped);
+	return ok;
+}
+
+#endif /* USE_TRACING */
@@ -45,12 +45,7 @@ Window::Window(const std::string & name, unsigned int height, unsigned int width
 		throw errMsg;
 	}
 
-	// Use VSync
-	if (SDL_GL_SetSwapInterval(1) < 0) {
-		std::string errMsg = "Unable to use VSync. Window object not created properly: ";
-		errMsg += SDL_GetError();
-		throw errMsg;
-	}
+	//swap interval is left to the frame pacer
 	SDL_WarpMouseInWindow(nullptr, m_width / 2, m_height / 2);
 	SDL_SetRelativeMouseMode (SDL_TRUE);
 }